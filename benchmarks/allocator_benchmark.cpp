@@ -0,0 +1,123 @@
+#include "../src/BP-Tree.hpp"
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory_resource>
+#include <random>
+#include <string>
+#include <vector>
+
+// Compares the node allocation policies: random inserts, a remove/insert churn phase
+// and tearing the tree down, with every node on the global heap, in per-tree slabs,
+// and in a monotonic arena. Then builds and drops many small request-scoped trees.
+// Usage: allocator_benchmark [key_count] [small_tree_count]   (default: 2'000'000 2'000)
+
+namespace {
+
+template <typename Func>
+double measure_seconds(Func func) {
+    auto start = std::chrono::high_resolution_clock::now();
+    func();
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+void report(const std::string& name, size_t count, double seconds) {
+    std::cout << name << ": " << count << " operations in " << seconds << " s, "
+              << (count / seconds) / 1e6 << " M operations/s\n";
+}
+
+using HeapTree = BPlusTree<int64_t, uint64_t>;
+using SlabTree = BPlusTree<int64_t, uint64_t, 128, std::less<int64_t>, 128, SlabNodeAllocator>;
+
+template <typename Tree>
+void run(const std::string& name, const std::vector<int64_t>& keys, std::pmr::memory_resource* resource) {
+    auto* tree = resource ? new Tree(resource) : new Tree();
+
+    double seconds = measure_seconds([&]() {
+        for (size_t i = 0; i < keys.size(); ++i) {
+            tree->insert(keys[i], i);
+        }
+    });
+    report(name + " insert ", keys.size(), seconds);
+
+    // Removing half of the keys merges leaves away, reinserting them splits new ones
+    seconds = measure_seconds([&]() {
+        for (size_t i = 0; i < keys.size(); i += 2) {
+            tree->remove(keys[i]);
+        }
+        for (size_t i = 0; i < keys.size(); i += 2) {
+            tree->insert(keys[i], i);
+        }
+    });
+    report(name + " churn  ", keys.size(), seconds);
+
+    size_t found = 0;
+    seconds = measure_seconds([&]() {
+        for (auto key : keys) {
+            found += tree->find(key).size();
+        }
+    });
+    report(name + " find   ", keys.size(), seconds);
+
+    seconds = measure_seconds([&]() { delete tree; });
+    std::cout << name << " destroy: " << seconds << " s\n";
+
+    if (found < keys.size()) {
+        std::cerr << name << ": wrong results\n";
+        std::exit(1);
+    }
+}
+
+// Many short-lived trees of 1000 keys, as an index built for a single request
+template <typename Make>
+void small_trees(const std::string& name, size_t count, Make make) {
+    double seconds = measure_seconds([&]() {
+        for (size_t t = 0; t < count; ++t) {
+            make([](auto& tree) {
+                for (int64_t i = 0; i < 1000; ++i) {
+                    tree.insert((i * 7919) % 1000, i);
+                }
+            });
+        }
+    });
+    report(name, count * 1000, seconds);
+}
+
+} // namespace
+
+
+int main(int argc, char** argv) {
+    size_t count = argc > 1 ? std::stoull(argv[1]) : 2'000'000;
+    size_t small_count = argc > 2 ? std::stoull(argv[2]) : 2'000;
+
+    std::mt19937_64 rng(20);
+    std::vector<int64_t> keys(count);
+    for (auto& key : keys) {
+        key = static_cast<int64_t>(rng() >> 1);
+    }
+
+    run<HeapTree>("heap     ", keys, nullptr);
+    run<SlabTree>("slab     ", keys, nullptr);
+    {
+        std::pmr::monotonic_buffer_resource arena;
+        run<HeapTree>("monotonic", keys, &arena);
+    }
+
+    small_trees("small trees, heap     ", small_count, [](auto fill) {
+        HeapTree tree;
+        fill(tree);
+    });
+    small_trees("small trees, slab     ", small_count, [](auto fill) {
+        SlabTree tree;
+        fill(tree);
+    });
+    std::vector<std::byte> buffer(1 << 20);
+    small_trees("small trees, monotonic", small_count, [&buffer](auto fill) {
+        std::pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size());
+        HeapTree tree(&arena);
+        fill(tree);
+    });
+
+    return 0;
+}
@@ -0,0 +1,79 @@
+#include "../src/BP-Tree.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Applies batches of random updates to a live tree, once as a loop of insert() and
+// once through insert_batch().
+// Usage: batch_benchmark [tree_key_count] [update_count]   (default: 5'000'000 2'000'000)
+
+namespace {
+
+template <typename Func>
+double measure_seconds(Func func) {
+    auto start = std::chrono::high_resolution_clock::now();
+    func();
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+void report(const std::string& name, size_t count, double seconds) {
+    std::cout << name << ": " << count << " keys in " << seconds << " s, "
+              << (count / seconds) / 1e6 << " M inserts/s\n";
+}
+
+using Tree = BPlusTree<int64_t, uint64_t>;
+
+// A tree holding the even keys below 2 * count
+Tree make_tree(size_t count) {
+    std::vector<std::pair<int64_t, uint64_t>> entries(count);
+    for (size_t i = 0; i < count; ++i) {
+        entries[i] = {static_cast<int64_t>(2 * i), i};
+    }
+    Tree tree;
+    tree.bulk_load(entries.begin(), entries.end(), 0.7);
+    return tree;
+}
+
+} // namespace
+
+
+int main(int argc, char** argv) {
+    size_t tree_keys = argc > 1 ? std::stoull(argv[1]) : 5'000'000;
+    size_t updates = argc > 2 ? std::stoull(argv[2]) : 2'000'000;
+
+    // Odd keys spread over the whole key range
+    std::mt19937_64 rng(1);
+    std::vector<std::pair<int64_t, uint64_t>> entries(updates);
+    for (auto& entry : entries) {
+        entry = {static_cast<int64_t>(2 * (rng() % tree_keys) + 1), rng()};
+    }
+
+    {
+        Tree tree = make_tree(tree_keys);
+        double seconds = measure_seconds([&]() {
+            for (const auto& [key, id] : entries) {
+                tree.insert(key, id);
+            }
+        });
+        report("insert loop", updates, seconds);
+    }
+
+    for (size_t batch_size : {10'000, 100'000}) {
+        Tree tree = make_tree(tree_keys);
+        double seconds = measure_seconds([&]() {
+            for (size_t offset = 0; offset < updates; offset += batch_size) {
+                size_t size = std::min(batch_size, updates - offset);
+                tree.insert_batch({entries.data() + offset, size});
+            }
+        });
+        report("insert_batch of " + std::to_string(batch_size), updates, seconds);
+    }
+
+    return 0;
+}
@@ -0,0 +1,91 @@
+#include "../src/BP-Tree.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Measures insert and find throughput with 1..64 threads working on disjoint key ranges
+// of one shared tree.
+// Usage: concurrency_benchmark [total_key_count] [coupling|blink]   (default: 4'000'000 coupling)
+
+namespace {
+
+template <typename Func>
+double measure_seconds(Func func) {
+    auto start = std::chrono::high_resolution_clock::now();
+    func();
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+template <typename Worker>
+void run_threads(size_t thread_count, Worker worker) {
+    std::vector<std::thread> threads;
+    threads.reserve(thread_count);
+    for (size_t t = 0; t < thread_count; ++t) {
+        threads.emplace_back(worker, t);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+void report(const std::string& name, size_t threads, size_t count, double seconds) {
+    std::cout << name << " threads=" << threads << ": " << count << " ops in " << seconds
+              << " s, " << (count / seconds) / 1e6 << " M ops/s\n";
+}
+
+} // namespace
+
+
+int main(int argc, char** argv) {
+    size_t count = argc > 1 ? std::stoull(argv[1]) : 4'000'000;
+    ConcurrencyMode mode = argc > 2 && std::string(argv[2]) == "blink"
+                         ? ConcurrencyMode::BLink : ConcurrencyMode::LatchCoupling;
+
+    for (size_t threads = 1; threads <= 64; threads *= 2) {
+        size_t per_thread = count / threads;
+
+        // Thread t owns keys [t * per_thread, (t + 1) * per_thread), inserted in shuffled order
+        std::vector<std::vector<int64_t>> keys(threads);
+        for (size_t t = 0; t < threads; ++t) {
+            keys[t].resize(per_thread);
+            std::iota(keys[t].begin(), keys[t].end(), static_cast<int64_t>(t * per_thread));
+            std::shuffle(keys[t].begin(), keys[t].end(), std::mt19937_64(t));
+        }
+
+        BPlusTree<int64_t, uint64_t> tree(mode);
+
+        double insert_seconds = measure_seconds([&]() {
+            run_threads(threads, [&](size_t t) {
+                for (auto key : keys[t]) {
+                    tree.insert(key, static_cast<uint64_t>(key));
+                }
+            });
+        });
+        report("insert", threads, per_thread * threads, insert_seconds);
+
+        std::vector<size_t> found(threads, 0);
+        double find_seconds = measure_seconds([&]() {
+            run_threads(threads, [&](size_t t) {
+                for (auto key : keys[t]) {
+                    found[t] += tree.find(key).size();
+                }
+            });
+        });
+        report("find  ", threads, per_thread * threads, find_seconds);
+
+        size_t total_found = std::accumulate(found.begin(), found.end(), size_t{0});
+        if (total_found != per_thread * threads) {
+            std::cerr << "lost keys: found " << total_found << " of " << per_thread * threads << "\n";
+            return 1;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,108 @@
+#include "../src/BP-Tree.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Point lookups in a large bulk-loaded tree for several internal fan-outs over the same
+// leaves: wider internal nodes make the tree shorter, so a descent touches fewer nodes.
+// Usage: fanout_benchmark [tree_key_count] [lookup_count]   (default: 100'000'000 10'000'000)
+
+namespace {
+
+template <typename Func>
+double measure_seconds(Func func) {
+    auto start = std::chrono::high_resolution_clock::now();
+    func();
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+void report(const std::string& name, size_t count, double seconds) {
+    std::cout << name << ": " << count << " lookups in " << seconds << " s, "
+              << (count / seconds) / 1e6 << " M lookups/s\n";
+}
+
+// Yields the entries (2i, i) without materializing them, so the input of bulk_load
+// costs no memory next to the tree
+struct EvenKeys {
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::pair<int64_t, uint64_t>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const value_type*;
+    using reference = value_type;
+
+    uint64_t i;
+
+    value_type operator*() const { return {static_cast<int64_t>(2 * i), i}; }
+    EvenKeys& operator++() { ++i; return *this; }
+    EvenKeys operator++(int) { EvenKeys old = *this; ++i; return old; }
+    bool operator==(const EvenKeys& other) const { return i == other.i; }
+    bool operator!=(const EvenKeys& other) const { return i != other.i; }
+};
+
+template <size_t LeafOrder, size_t InternalOrder>
+void run(size_t tree_keys, const std::vector<int64_t>& keys) {
+    const std::string name = "leaf " + std::to_string(LeafOrder) + ", internal " + std::to_string(InternalOrder);
+
+    // One tree at a time: at the default size a tree takes a couple of GB
+    BPlusTree<int64_t, uint64_t, LeafOrder, std::less<int64_t>, InternalOrder> tree;
+    tree.bulk_load(EvenKeys{0}, EvenKeys{tree_keys}, 0.9);
+    std::cout << name << ": height " << tree.height() << ", fill factor " << tree.fill_factor()
+              << ", internal node " << sizeof(InternalNode<int64_t, uint64_t, LeafOrder, InternalOrder>) << " bytes\n";
+
+    size_t found = 0;
+    double seconds = measure_seconds([&]() {
+        for (auto key : keys) {
+            found += tree.find(key).size();
+        }
+    });
+    report(name + " find     ", keys.size(), seconds);
+
+    const size_t batch = 512;
+    size_t found_many = 0;
+    seconds = measure_seconds([&]() {
+        for (size_t first = 0; first < keys.size(); first += batch) {
+            size_t count = std::min(batch, keys.size() - first);
+            auto results = tree.find_many({keys.data() + first, count});
+            for (size_t i = 0; i < results.size(); ++i) {
+                found_many += results[i].size();
+            }
+        }
+    });
+    report(name + " find_many", keys.size(), seconds);
+
+    if (found != found_many) {
+        std::cerr << name << ": results differ\n";
+        std::exit(1);
+    }
+}
+
+} // namespace
+
+
+int main(int argc, char** argv) {
+    size_t tree_keys = argc > 1 ? std::stoull(argv[1]) : 100'000'000;
+    size_t lookups = argc > 2 ? std::stoull(argv[2]) : 10'000'000;
+
+    // Half of the lookups hit an (even) key of the tree
+    std::mt19937_64 rng(19);
+    std::vector<int64_t> keys(lookups);
+    for (auto& key : keys) {
+        key = static_cast<int64_t>(rng() % (2 * tree_keys));
+    }
+
+    run<128, 128>(tree_keys, keys);
+    run<128, 512>(tree_keys, keys);
+    run<128, 2048>(tree_keys, keys);
+    run<32, 32>(tree_keys, keys);
+    run<32, 512>(tree_keys, keys);
+
+    return 0;
+}
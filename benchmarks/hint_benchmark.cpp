@@ -0,0 +1,160 @@
+#include "../src/BP-Tree.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Compares find() and insert() with and without a SearchHint on access patterns with
+// key locality: a random walk over the key space, and Zipfian-distributed clusters of
+// neighbouring keys. Uniform random keys show what a hint costs when it never hits.
+// Usage: hint_benchmark [tree_key_count] [operation_count]   (default: 5'000'000 5'000'000)
+
+namespace {
+
+template <typename Func>
+double measure_seconds(Func func) {
+    auto start = std::chrono::high_resolution_clock::now();
+    func();
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+void report(const std::string& name, size_t count, double seconds) {
+    std::cout << name << ": " << count << " operations in " << seconds << " s, "
+              << (count / seconds) / 1e6 << " M operations/s\n";
+}
+
+using Tree = BPlusTree<int64_t, uint64_t>;
+
+// The generators below pick positions; a position p stands for the keys p << SPREAD
+// and up, so every insert can use a key of its own next to the position
+constexpr int SPREAD = 24;
+
+// A tree holding the keys of the even positions below 2 * count
+Tree make_tree(size_t count) {
+    std::vector<std::pair<int64_t, uint64_t>> entries(count);
+    for (size_t i = 0; i < count; ++i) {
+        entries[i] = {static_cast<int64_t>(2 * i) << SPREAD, i};
+    }
+    Tree tree;
+    tree.bulk_load(entries.begin(), entries.end(), 0.7);
+    return tree;
+}
+
+// Steps of at most a few positions in either direction
+std::vector<int64_t> random_walk(size_t tree_keys, size_t count, std::mt19937_64& rng) {
+    std::vector<int64_t> keys(count);
+    int64_t key = static_cast<int64_t>(tree_keys);
+    for (auto& k : keys) {
+        key = std::clamp<int64_t>(key + static_cast<int64_t>(rng() % 17) - 8, 0,
+                                  static_cast<int64_t>(2 * tree_keys - 1));
+        k = key;
+    }
+    return keys;
+}
+
+// Runs of 16 adjacent positions starting at a Zipfian-chosen cluster of the key space
+std::vector<int64_t> zipf_clusters(size_t tree_keys, size_t count, std::mt19937_64& rng) {
+    const size_t clusters = tree_keys / 64;
+    const double skew = 0.99;
+
+    std::vector<double> cumulative(clusters);
+    double sum = 0;
+    for (size_t i = 0; i < clusters; ++i) {
+        sum += 1.0 / std::pow(static_cast<double>(i + 1), skew);
+        cumulative[i] = sum;
+    }
+
+    // Hot clusters are spread over the key space instead of sitting at its start
+    std::vector<size_t> placement(clusters);
+    for (size_t i = 0; i < clusters; ++i) {
+        placement[i] = i;
+    }
+    std::shuffle(placement.begin(), placement.end(), rng);
+
+    std::uniform_real_distribution<double> uniform(0, sum);
+    std::vector<int64_t> keys(count);
+    for (size_t i = 0; i < count; i += 16) {
+        size_t rank = std::lower_bound(cumulative.begin(), cumulative.end(), uniform(rng)) - cumulative.begin();
+        int64_t first = static_cast<int64_t>(placement[rank] * 128);
+        for (size_t j = i; j < std::min(count, i + 16); ++j) {
+            keys[j] = first + static_cast<int64_t>(j - i);
+        }
+    }
+    return keys;
+}
+
+// Positions drawn uniformly, where a hint never hits
+std::vector<int64_t> uniform_keys(size_t tree_keys, size_t count, std::mt19937_64& rng) {
+    std::vector<int64_t> keys(count);
+    for (auto& key : keys) {
+        key = static_cast<int64_t>(rng() % (2 * tree_keys));
+    }
+    return keys;
+}
+
+void compare(const std::string& name, size_t tree_keys, const std::vector<int64_t>& keys) {
+    {
+        Tree tree = make_tree(tree_keys);
+        size_t found = 0;
+        double seconds = measure_seconds([&]() {
+            for (auto key : keys) {
+                found += tree.find(key << SPREAD).size();
+            }
+        });
+        report(name + " find          ", keys.size(), seconds);
+
+        Tree::SearchHint hint;
+        size_t found_hinted = 0;
+        seconds = measure_seconds([&]() {
+            for (auto key : keys) {
+                found_hinted += tree.find(key << SPREAD, hint).size();
+            }
+        });
+        report(name + " find (hint)   ", keys.size(), seconds);
+        if (found != found_hinted) {
+            std::cerr << name << ": results differ\n";
+            std::exit(1);
+        }
+    }
+
+    {
+        Tree tree = make_tree(tree_keys);
+        double seconds = measure_seconds([&]() {
+            for (size_t i = 0; i < keys.size(); ++i) {
+                tree.insert((keys[i] << SPREAD) + static_cast<int64_t>(i % (1 << SPREAD)) + 1, i);
+            }
+        });
+        report(name + " insert        ", keys.size(), seconds);
+    }
+
+    {
+        Tree tree = make_tree(tree_keys);
+        Tree::SearchHint hint;
+        double seconds = measure_seconds([&]() {
+            for (size_t i = 0; i < keys.size(); ++i) {
+                tree.insert((keys[i] << SPREAD) + static_cast<int64_t>(i % (1 << SPREAD)) + 1, i, hint);
+            }
+        });
+        report(name + " insert (hint) ", keys.size(), seconds);
+    }
+}
+
+} // namespace
+
+
+int main(int argc, char** argv) {
+    size_t tree_keys = argc > 1 ? std::stoull(argv[1]) : 5'000'000;
+    size_t operations = argc > 2 ? std::stoull(argv[2]) : 5'000'000;
+
+    std::mt19937_64 rng(5);
+    compare("random walk", tree_keys, random_walk(tree_keys, operations, rng));
+    compare("zipf       ", tree_keys, zipf_clusters(tree_keys, operations, rng));
+    compare("uniform    ", tree_keys, uniform_keys(tree_keys, operations, rng));
+
+    return 0;
+}
@@ -0,0 +1,76 @@
+#include "../src/BP-Tree.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Measures single-key insert throughput for sequential and shuffled key streams, and
+// bulk_load() of the same sorted keys at two fill factors.
+// Usage: insert_benchmark [key_count]   (default: 10'000'000)
+
+namespace {
+
+template <typename Func>
+double measure_seconds(Func func) {
+    auto start = std::chrono::high_resolution_clock::now();
+    func();
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+void report(const std::string& name, size_t count, double seconds, size_t height) {
+    std::cout << name << ": " << count << " keys in " << seconds << " s, "
+              << (count / seconds) / 1e6 << " M inserts/s, height " << height << "\n";
+}
+
+} // namespace
+
+
+int main(int argc, char** argv) {
+    size_t count = argc > 1 ? std::stoull(argv[1]) : 10'000'000;
+
+    std::vector<int64_t> keys(count);
+    std::iota(keys.begin(), keys.end(), 0);
+
+    {
+        BPlusTree<int64_t, uint64_t> tree;
+        double seconds = measure_seconds([&]() {
+            for (auto key : keys) {
+                tree.insert(key, static_cast<uint64_t>(key));
+            }
+        });
+        report("sequential", count, seconds, tree.height());
+    }
+
+    for (double fill : {1.0, 0.9}) {
+        std::vector<std::pair<int64_t, uint64_t>> entries(count);
+        for (size_t i = 0; i < count; ++i) {
+            entries[i] = {keys[i], static_cast<uint64_t>(keys[i])};
+        }
+
+        BPlusTree<int64_t, uint64_t> tree;
+        double seconds = measure_seconds([&]() {
+            tree.bulk_load(entries.begin(), entries.end(), fill);
+        });
+        report("bulk_load fill " + std::to_string(fill).substr(0, 3), count, seconds, tree.height());
+    }
+
+    std::shuffle(keys.begin(), keys.end(), std::mt19937_64(42));
+
+    {
+        BPlusTree<int64_t, uint64_t> tree;
+        double seconds = measure_seconds([&]() {
+            for (auto key : keys) {
+                tree.insert(key, static_cast<uint64_t>(key));
+            }
+        });
+        report("random", count, seconds, tree.height());
+    }
+
+    return 0;
+}
@@ -0,0 +1,126 @@
+#include "../src/BP-Tree.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Sweeps the node size of a NodeSizePolicy for a small and a large key type: random
+// inserts, point lookups and short range scans for each size, next to the fixed
+// default Order of 128.
+// Usage: node_size_benchmark [key_count]   (default: 2'000'000)
+
+namespace {
+
+template <typename Func>
+double measure_seconds(Func func) {
+    auto start = std::chrono::high_resolution_clock::now();
+    func();
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+using LargeKey = CompositeKey<std::string, int, double>;
+
+template <typename Key>
+std::vector<Key> make_keys(size_t count, std::mt19937_64& rng);
+
+template <>
+std::vector<int64_t> make_keys<int64_t>(size_t count, std::mt19937_64& rng) {
+    std::vector<int64_t> keys(count);
+    for (auto& key : keys) {
+        key = static_cast<int64_t>(rng() >> 1);
+    }
+    return keys;
+}
+
+template <>
+std::vector<LargeKey> make_keys<LargeKey>(size_t count, std::mt19937_64& rng) {
+    std::vector<LargeKey> keys;
+    keys.reserve(count);
+    char name[16];
+    for (size_t i = 0; i < count; ++i) {
+        std::snprintf(name, sizeof(name), "user%09u", static_cast<unsigned>(rng() % 1'000'000'000));
+        keys.emplace_back(std::string(name), static_cast<int>(rng() % 1000), static_cast<double>(i));
+    }
+    return keys;
+}
+
+// One line per configuration: orders, node sizes, then M operations/s for each workload
+template <typename Tree, typename Key>
+void run(const std::string& name, const std::vector<Key>& keys, const std::vector<Key>& sorted) {
+    Tree tree;
+    double insert_seconds = measure_seconds([&]() {
+        for (size_t i = 0; i < keys.size(); ++i) {
+            tree.insert(keys[i], i);
+        }
+    });
+
+    size_t found = 0;
+    double find_seconds = measure_seconds([&]() {
+        for (const auto& key : keys) {
+            found += tree.find(key).size();
+        }
+    });
+
+    // Ranges of about 100 entries starting at every 100th key
+    size_t scanned = 0;
+    size_t scans = 0;
+    double scan_seconds = measure_seconds([&]() {
+        for (size_t i = 0; i + 100 < sorted.size(); i += 100, ++scans) {
+            scanned += tree.scan(sorted[i], sorted[i + 99], [](const Key&, const uint64_t&) {});
+        }
+    });
+
+    std::cout << name << ": height " << tree.height() << ", "
+              << (keys.size() / insert_seconds) / 1e6 << " M inserts/s, "
+              << (keys.size() / find_seconds) / 1e6 << " M finds/s, "
+              << (scanned / scan_seconds) / 1e6 << " M scanned/s\n";
+    if (found < keys.size() || scanned < scans * 100) {
+        std::cerr << name << ": wrong results\n";
+        std::exit(1);
+    }
+}
+
+template <typename Key, size_t NodeBytes>
+void run_sized(const std::string& type_name, const std::vector<Key>& keys, const std::vector<Key>& sorted) {
+    using Policy = NodeSizePolicy<NodeBytes>;
+    constexpr size_t leaf_order = Policy::template leaf_order<Key, uint64_t>;
+    constexpr size_t internal_order = Policy::template internal_order<Key, uint64_t>;
+
+    run<SizedBPlusTree<Key, uint64_t, Policy>>(
+        type_name + " " + std::to_string(NodeBytes / 1024) + " KiB (leaf " + std::to_string(leaf_order) +
+            ", internal " + std::to_string(internal_order) + ")",
+        keys, sorted);
+}
+
+template <typename Key>
+void sweep(const std::string& type_name, size_t count) {
+    std::mt19937_64 rng(3);
+    std::vector<Key> keys = make_keys<Key>(count, rng);
+    std::vector<Key> sorted = keys;
+    std::sort(sorted.begin(), sorted.end());
+
+    run<BPlusTree<Key, uint64_t>>(type_name + " Order 128 (" +
+                                  std::to_string(sizeof(LeafNode<Key, uint64_t, 128>) / 1024) + " KiB leaves)",
+                                  keys, sorted);
+    run_sized<Key, 1024>(type_name, keys, sorted);
+    run_sized<Key, 4096>(type_name, keys, sorted);
+    run_sized<Key, 16384>(type_name, keys, sorted);
+    run_sized<Key, 65536>(type_name, keys, sorted);
+}
+
+} // namespace
+
+
+int main(int argc, char** argv) {
+    size_t count = argc > 1 ? std::stoull(argv[1]) : 2'000'000;
+
+    sweep<int64_t>("int64    ", count);
+    sweep<LargeKey>("composite", count);
+
+    return 0;
+}
@@ -0,0 +1,88 @@
+#include "../src/Normalized-Key-Tree.hpp"
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Multi-column keys (tenant, name, version): a tree of CompositeKeys, which compares
+// the tuple component by component, against NormalizedKeyTrees, which compare the
+// encoded bytes, stored inline or as std::string. Measures random inserts and point
+// lookups.
+// Usage: normalized_key_benchmark [key_count] [lookup_count]   (default: 1'000'000 5'000'000)
+
+namespace {
+
+using Key = CompositeKey<int32_t, std::string, int64_t>;
+
+template <typename Func>
+double measure_seconds(Func func) {
+    auto start = std::chrono::high_resolution_clock::now();
+    func();
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+void report(const std::string& name, size_t count, double seconds) {
+    std::cout << name << ": " << count << " operations in " << seconds << " s, "
+              << (count / seconds) / 1e6 << " M operations/s\n";
+}
+
+template <typename Tree>
+void run(const std::string& name, const std::vector<Key>& keys, const std::vector<Key>& lookups) {
+    Tree tree;
+    double seconds = measure_seconds([&]() {
+        for (size_t i = 0; i < keys.size(); ++i) {
+            tree.insert(keys[i], i);
+        }
+    });
+    report(name + " insert", keys.size(), seconds);
+
+    size_t found = 0;
+    seconds = measure_seconds([&]() {
+        for (const auto& key : lookups) {
+            found += tree.find(key).size();
+        }
+    });
+    report(name + " find  ", lookups.size(), seconds);
+
+    if (found < lookups.size()) {
+        std::cerr << name << ": wrong results\n";
+        std::exit(1);
+    }
+}
+
+} // namespace
+
+
+int main(int argc, char** argv) {
+    size_t count = argc > 1 ? std::stoull(argv[1]) : 1'000'000;
+    size_t lookup_count = argc > 2 ? std::stoull(argv[2]) : 5'000'000;
+
+    // Few tenants, so the first component rarely decides a comparison on its own. Names
+    // are random, or share a stem that makes the normalized keys' 8-byte prefixes tie.
+    std::mt19937_64 rng(23);
+    for (const std::string stem : {"", "user-"}) {
+        std::vector<Key> keys(count);
+        for (auto& key : keys) {
+            std::string name = stem;
+            for (int i = 0; i < 10; ++i) {
+                name += static_cast<char>('a' + rng() % 26);
+            }
+            key = Key(static_cast<int32_t>(rng() % 16), name, static_cast<int64_t>(rng() % 4));
+        }
+        std::vector<Key> lookups(lookup_count);
+        for (auto& key : lookups) {
+            key = keys[rng() % keys.size()];
+        }
+
+        std::cout << (stem.empty() ? "random names\n" : "names with a common stem\n");
+        run<BPlusTree<Key, uint64_t>>("composite         ", keys, lookups);
+        run<NormalizedKeyTree<Key, uint64_t>>("normalized, inline", keys, lookups);
+        run<NormalizedKeyTree<Key, uint64_t, 128, 0>>("normalized, string", keys, lookups);
+    }
+
+    return 0;
+}
@@ -0,0 +1,122 @@
+#include "../src/BP-Tree.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Compares the vectorized node search (key_lower_bound) with std::lower_bound on
+// sorted arrays the size of a full node, then measures find() and find_many() through
+// a whole tree.
+// Usage: search_benchmark [lookup_count] [tree_key_count]   (default: 20'000'000 1'000'000)
+
+namespace {
+
+constexpr size_t NODE_KEYS = 128;
+constexpr size_t NODE_COUNT = 4096;  // enough nodes that the arrays do not all stay in L1
+
+template <typename Func>
+double measure_seconds(Func func) {
+    auto start = std::chrono::high_resolution_clock::now();
+    func();
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+void report(const std::string& name, size_t count, double seconds) {
+    std::cout << name << ": " << count << " lookups in " << seconds << " s, "
+              << (count / seconds) / 1e6 << " M lookups/s\n";
+}
+
+template <typename Key>
+void compare_kernels(const std::string& type_name, size_t lookups) {
+    std::mt19937_64 rng(7);
+
+    // NODE_COUNT sorted node-sized arrays of distinct keys
+    std::vector<Key> nodes(NODE_KEYS * NODE_COUNT);
+    for (size_t n = 0; n < NODE_COUNT; ++n) {
+        for (size_t i = 0; i < NODE_KEYS; ++i) {
+            nodes[n * NODE_KEYS + i] = static_cast<Key>(i * 4 + rng() % 4);
+        }
+    }
+
+    std::vector<std::pair<size_t, Key>> probes(lookups);
+    for (auto& probe : probes) {
+        probe = {rng() % NODE_COUNT, static_cast<Key>(rng() % (NODE_KEYS * 4))};
+    }
+
+    size_t checksum_std = 0;
+    double std_seconds = measure_seconds([&]() {
+        for (const auto& [node, key] : probes) {
+            const Key* first = nodes.data() + node * NODE_KEYS;
+            checksum_std += std::lower_bound(first, first + NODE_KEYS, key, std::less<Key>()) - first;
+        }
+    });
+
+    size_t checksum_simd = 0;
+    double simd_seconds = measure_seconds([&]() {
+        for (const auto& [node, key] : probes) {
+            const Key* first = nodes.data() + node * NODE_KEYS;
+            checksum_simd += key_lower_bound(first, first + NODE_KEYS, key, std::less<Key>()) - first;
+        }
+    });
+
+    report(type_name + " std::lower_bound", lookups, std_seconds);
+    report(type_name + " key_lower_bound ", lookups, simd_seconds);
+    if (checksum_std != checksum_simd) {
+        std::cerr << type_name << ": results differ\n";
+        std::exit(1);
+    }
+}
+
+} // namespace
+
+
+int main(int argc, char** argv) {
+    size_t lookups = argc > 1 ? std::stoull(argv[1]) : 20'000'000;
+
+    compare_kernels<int32_t>("int32 ", lookups);
+    compare_kernels<uint32_t>("uint32", lookups);
+    compare_kernels<int64_t>("int64 ", lookups);
+    compare_kernels<double>("double", lookups);
+
+    // End to end: point lookups of random keys in the tree, one by one and in batches
+    size_t tree_keys = argc > 2 ? std::stoull(argv[2]) : 1'000'000;
+    BPlusTree<int64_t, uint64_t> tree;
+    for (size_t i = 0; i < tree_keys; ++i) {
+        tree.insert(static_cast<int64_t>(i), i);
+    }
+
+    std::mt19937_64 rng(11);
+    std::vector<int64_t> keys(lookups / 4);
+    for (auto& key : keys) {
+        key = static_cast<int64_t>(rng() % tree_keys);
+    }
+
+    size_t found = 0;
+    double seconds = measure_seconds([&]() {
+        for (auto key : keys) {
+            found += tree.find(key).size();
+        }
+    });
+    report("tree find", keys.size(), seconds);
+
+    const size_t batch = 512;
+    size_t found_many = 0;
+    seconds = measure_seconds([&]() {
+        for (size_t first = 0; first < keys.size(); first += batch) {
+            size_t count = std::min(batch, keys.size() - first);
+            auto results = tree.find_many({keys.data() + first, count});
+            for (size_t i = 0; i < results.size(); ++i) {
+                found_many += results[i].size();
+            }
+        }
+    });
+    report("tree find_many", keys.size(), seconds);
+
+    return found == keys.size() && found_many == keys.size() ? 0 : 1;
+}
@@ -0,0 +1,90 @@
+#include "../src/BP-Tree.hpp"
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Point lookups on string keys, searching the leaves by their 8-byte key prefixes
+// against comparing the full keys. Both trees have the same layout; the second one
+// only hides std::less from the prefix search (and from separator truncation). Run
+// once with keys whose prefixes mostly differ and once with keys that share their
+// first 20 bytes, which the leaves strip before taking the prefixes.
+// Usage: string_key_benchmark [tree_key_count] [lookup_count]   (default: 2'000'000 5'000'000)
+
+namespace {
+
+template <typename Func>
+double measure_seconds(Func func) {
+    auto start = std::chrono::high_resolution_clock::now();
+    func();
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+void report(const std::string& name, size_t count, double seconds) {
+    std::cout << name << ": " << count << " lookups in " << seconds << " s, "
+              << (count / seconds) / 1e6 << " M lookups/s\n";
+}
+
+// Orders strings like std::less, but is a different type, so leaves are searched key by key
+struct FullKeyLess {
+    bool operator()(const std::string& a, const std::string& b) const { return a < b; }
+};
+
+std::vector<std::string> make_keys(size_t count, const std::string& stem, std::mt19937_64& rng) {
+    std::vector<std::string> keys(count);
+    for (auto& key : keys) {
+        key = stem;
+        for (int i = 0; i < 16; ++i) {
+            key += static_cast<char>('a' + rng() % 26);
+        }
+    }
+    return keys;
+}
+
+template <typename Compare>
+void run(const std::string& name, const std::vector<std::string>& keys, const std::vector<std::string>& lookups) {
+    BPlusTree<std::string, uint64_t, 128, Compare> tree;
+    for (size_t i = 0; i < keys.size(); ++i) {
+        tree.insert(keys[i], i);
+    }
+
+    size_t found = 0;
+    double seconds = measure_seconds([&]() {
+        for (const auto& key : lookups) {
+            found += tree.find(key).size();
+        }
+    });
+    report(name, lookups.size(), seconds);
+
+    if (found != lookups.size()) {
+        std::cerr << name << ": wrong results\n";
+        std::exit(1);
+    }
+}
+
+} // namespace
+
+
+int main(int argc, char** argv) {
+    size_t count = argc > 1 ? std::stoull(argv[1]) : 2'000'000;
+    size_t lookup_count = argc > 2 ? std::stoull(argv[2]) : 5'000'000;
+
+    std::mt19937_64 rng(22);
+    for (const std::string stem : {"", "https://example.com/"}) {
+        auto keys = make_keys(count, stem, rng);
+        std::vector<std::string> lookups(lookup_count);
+        for (auto& key : lookups) {
+            key = keys[rng() % keys.size()];
+        }
+
+        std::string shape = stem.empty() ? "distinct prefixes" : "shared prefixes  ";
+        run<std::less<std::string>>(shape + ", prefix search  ", keys, lookups);
+        run<FullKeyLess>(shape + ", full-key search", keys, lookups);
+    }
+
+    return 0;
+}
@@ -2,15 +2,33 @@
 
 #include "../external/Data_Structures/Containers/Dynamic_Array.hpp"
 #include "../external/Data_Structures/Containers/Pair.hpp"
-#include "../external/Data_Structures/SmartPtrs/include/SharedPtr.hpp"
 #include "Composite-Key.hpp"
+#include "Epoch-Reclamation.hpp"
+#include "Fixed-Array.hpp"
+#include "Key-Search.hpp"
+#include "Node-Allocator.hpp"
+#include "Node-Pointer.hpp"
+#include "Optimistic-Latch.hpp"
+#include "Prefixed-Keys.hpp"
+#include <atomic>
+#include <cstdint>
 #include <functional>
+#include <iterator>
+#include <limits>
+#include <mutex>
+#include <optional>
 #include <shared_mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
 #include <variant>
+#include <vector>
 
 
 // forward declaration
-template <typename Key, typename RecordId, size_t Order>
+template <typename Key, typename RecordId, size_t Order, size_t InternalOrder = Order>
 struct InternalNode;
 
 template <typename Key, typename RecordId, size_t Order>
@@ -18,34 +36,52 @@ struct LeafNode;
 
 
 // CRTP (Curiously Recurring Template Pattern)
-template <typename Derived> struct BaseNode {
+template <typename Derived> struct BaseNode : ResourceAllocated, RefCounted {
     bool is_leaf() const {
         return static_cast<const Derived*>(this)->is_leaf_impl();
     }
 };
 
 
-template <typename Key, typename RecordId, size_t Order>
-using VariantNode = std::variant<
-    SharedPtr<InternalNode<Key, RecordId, Order>>, 
-    SharedPtr<LeafNode<Key, RecordId, Order>>, 
-    std::monostate>;
+template <typename Key, typename RecordId, size_t Order, size_t InternalOrder = Order>
+using VariantNode = ChildPtr<InternalNode<Key, RecordId, Order, InternalOrder>, LeafNode<Key, RecordId, Order>>;
 
 
 
-template <typename Key, typename RecordId, size_t Order>
-struct InternalNode : public BaseNode<InternalNode<Key, RecordId, Order>> {
+// An internal node of a tree whose leaves hold up to Order entries; it has up to
+// InternalOrder children
+template <typename Key, typename RecordId, size_t Order, size_t InternalOrder>
+struct InternalNode : public BaseNode<InternalNode<Key, RecordId, Order, InternalOrder>> {
 
-    mutable std::shared_mutex mutex_; 
+    mutable OptimisticLatch mutex_; 
     
-    DynamicArray<Key> keys_; 
+    // Inline, so a node is one allocation and its buffers never move under an
+    // optimistic reader. One slot of slack lets a node overflow before it splits.
+    FixedArray<Key, InternalOrder> keys_; 
     
-    DynamicArray<VariantNode<Key, RecordId, Order>> children_; 
+    FixedArray<VariantNode<Key, RecordId, Order, InternalOrder>, InternalOrder + 1> children_; 
+
+    // Number of entries under each child; only kept up to date when the tree was
+    // created with SubtreeCounts::On
+    FixedArray<size_t, InternalOrder + 1> counts_;
+
+    // Upper bound of the subtree (the parent separator to its right) and the next node
+    // on the same level; the rightmost node of a level has no high key
+    Key high_key_;
+    bool has_high_key_;
+    NodePtr<InternalNode> right_;
+
+    // Distance to the leaf level: 0 when the children are leaves
+    size_t level_;
 
     bool is_leaf_impl() const noexcept { return false; }
+    const NodePtr<InternalNode>& right_sibling() const noexcept { return right_; }
 
-    InternalNode() : keys_(), children_() {}
-    ~InternalNode() {}
+    InternalNode() : keys_(), children_(), counts_(), high_key_(), has_high_key_(false), right_(nullptr), level_(0) {}
+    // Children are released front to back. Every leaf is also owned by the next_ of its
+    // left neighbour, so the array's own back-to-front destruction would keep the leaves
+    // alive until the first one goes, and then free the whole chain recursively.
+    ~InternalNode() { children_.clear(); }
 
     size_t size() const;
     bool is_full() const;
@@ -59,18 +95,29 @@ struct InternalNode : public BaseNode<InternalNode<Key, RecordId, Order>> {
 template <typename Key, typename RecordId, size_t Order>
 struct LeafNode : public BaseNode<LeafNode<Key, RecordId, Order>> {
 
-    mutable std::shared_mutex mutex_; 
+    mutable OptimisticLatch mutex_; 
     
-    DynamicArray<Key> keys_;
+    // A leaf holds up to Order entries inline; it splits as soon as it reaches Order.
+    // Keys with a KeyPrefix also keep an array of prefixes that searches run over.
+    LeafKeyArray<Key, Order> keys_;
     
-    DynamicArray<RecordId> values_;
+    FixedArray<RecordId, Order> values_;
     
-    SharedPtr<LeafNode> next_;
+    NodePtr<LeafNode> next_;
+
+    // Non-owning link to the left neighbour. Writers that splice a leaf in or out set it
+    // on the leaf to their right without latching that leaf, hence the atomic.
+    std::atomic<LeafNode*> prev_;
+
+    // Upper bound of the leaf (the parent separator to its right); the last leaf has none
+    Key high_key_;
+    bool has_high_key_;
 
 
     bool is_leaf_impl() const noexcept { return true; }
+    const NodePtr<LeafNode>& right_sibling() const noexcept { return next_; }
 
-    LeafNode() : keys_(), values_(), next_(nullptr) {}
+    LeafNode() : keys_(), values_(), next_(nullptr), prev_(nullptr), high_key_(), has_high_key_(false) {}
 
     size_t size() const;
     bool is_full() const;
@@ -80,6 +127,96 @@ struct LeafNode : public BaseNode<LeafNode<Key, RecordId, Order>> {
 
 
 
+/**
+ * @brief How concurrent writers coordinate with each other and with readers
+ * 
+ * - LatchCoupling: writers latch top-down and keep every ancestor that a split or
+ *   merge may reach; underfull nodes are rebalanced.
+ * - BLink: Lehman-Yao B-link protocol. Every operation holds at most one latch per
+ *   level on the way down and moves right along sibling links past nodes that split
+ *   under it. Splits propagate bottom-up, so a writer never blocks readers above the
+ *   node it modifies. Removes only touch leaves; nodes are never merged and may stay
+ *   underfull or empty.
+ */
+
+enum class ConcurrencyMode { LatchCoupling, BLink };
+
+
+
+/**
+ * @brief Whether internal nodes count the entries under each of their children
+ * 
+ * The counts make count(), rank() and select() O(log n). Keeping them exact means
+ * every insert and remove updates the whole root-to-leaf path, so writers latch that
+ * path exclusively and no longer run concurrently with each other. Only available
+ * with ConcurrencyMode::LatchCoupling.
+ */
+
+enum class SubtreeCounts { Off, On };
+
+
+
+/**
+ * @brief Leaf and internal fan-out that keep each node within a target size in bytes
+ * 
+ * @tparam NodeBytes Upper bound for sizeof a node, e.g. 4096 for a page or 16 KiB / 64 KiB
+ *         for larger blocks
+ * 
+ * @details
+ * A leaf slot holds a key, a record id and, for keys with a KeyPrefix, the key's prefix;
+ * an internal slot a key, a child pointer and a subtree count, so for the same size an
+ * internal node fans out differently from a leaf. The orders are computed from the node
+ * types themselves and are the largest whose sizeof fits, but never below 4. Use with
+ * SizedBPlusTree.
+ */
+
+template <size_t NodeBytes>
+struct NodeSizePolicy {
+  private:
+
+    // Order of a node that is Node, the smallest instantiation, plus as many slots as fit
+    template <typename Node>
+    static constexpr size_t estimate(size_t slot_bytes) {
+        constexpr size_t minimum = sizeof(Node);
+        return NodeBytes > minimum ? 4 + (NodeBytes - minimum) / slot_bytes : 4;
+    }
+
+    // The estimate ignores padding at the end of the node's arrays; step down until it fits
+    template <typename Key, typename RecordId, size_t Order>
+    static constexpr size_t fit_leaf() {
+        if constexpr (Order <= 4 || sizeof(LeafNode<Key, RecordId, Order>) <= NodeBytes) {
+            return Order;
+        } else {
+            return fit_leaf<Key, RecordId, Order - 1>();
+        }
+    }
+
+    template <typename Key, typename RecordId, size_t InternalOrder>
+    static constexpr size_t fit_internal() {
+        if constexpr (InternalOrder <= 4 || sizeof(InternalNode<Key, RecordId, 4, InternalOrder>) <= NodeBytes) {
+            return InternalOrder;
+        } else {
+            return fit_internal<Key, RecordId, InternalOrder - 1>();
+        }
+    }
+
+  public:
+
+    static constexpr size_t node_bytes = NodeBytes;
+
+    template <typename Key, typename RecordId>
+    static constexpr size_t leaf_order = fit_leaf<Key, RecordId,
+        estimate<LeafNode<Key, RecordId, 4>>(
+            sizeof(Key) + sizeof(RecordId) + (KeyPrefix<Key>::enabled ? sizeof(uint64_t) : 0))>();
+
+    template <typename Key, typename RecordId>
+    static constexpr size_t internal_order = fit_internal<Key, RecordId,
+        estimate<InternalNode<Key, RecordId, 4, 4>>(
+            sizeof(Key) + sizeof(VariantNode<Key, RecordId, 4>) + sizeof(size_t))>();
+};
+
+
+
 /**
  * @brief A B+ Tree implementation for efficient storage and retrieval of key-value pairs.
  * 
@@ -88,49 +225,279 @@ struct LeafNode : public BaseNode<LeafNode<Key, RecordId, Order>> {
  * 
  * @tparam Key The type of the keys stored in the tree.
  * @tparam RecordId The type of the record IDs associated with the keys.
- * @tparam Order The maximum number of children per node (default is 128).
+ * @tparam Order The capacity of a leaf; it splits when it reaches Order entries (default is 128).
  * @tparam compare The comparison function for keys (default is std::less<Key>).
+ * @tparam InternalOrder The maximum number of children per internal node (default is Order).
+ *         Internal nodes hold no record ids, so the same node size fits more of them.
+ * @tparam NodeAllocator Where nodes are allocated: HeapNodeAllocator (default) gives each
+ *         node its own allocation, SlabNodeAllocator packs them into per-tree slabs.
  */
 
 
-template <typename Key, typename RecordId, size_t Order = 128, typename compare = std::less<Key>>
+template <typename Key, typename RecordId, size_t Order = 128, typename compare = std::less<Key>,
+          size_t InternalOrder = Order, typename NodeAllocator = HeapNodeAllocator>
 class BPlusTree {
 
+  public:
+
+    /**
+     * @brief Caller-owned finger into the tree for workloads with key locality
+     *
+     * @details
+     * Remembers the leaf the last hinted operation ended in. The next find(), insert()
+     * or lower_bound() given the hint starts at that leaf when the key lies strictly
+     * inside the leaf's key range, and descends from the root otherwise. A hint is
+     * dropped as soon as any node has been retired since it was taken, so a stale hint
+     * only costs the descent it failed to save. A hint belongs to one tree and one
+     * thread at a time and must not outlive the tree.
+     */
+    class SearchHint {
+      private:
+        const BPlusTree* tree_ = nullptr;
+        LeafNode<Key, RecordId, Order>* leaf_ = nullptr;
+        uint64_t retirements_ = 0;
+
+        friend class BPlusTree;
+
+      public:
+        void reset() { leaf_ = nullptr; }
+    };
+
   private:
 
-    using InternalNodePtr = SharedPtr<InternalNode<Key, RecordId, Order>>;
-    using LeafNodePtr = SharedPtr<LeafNode<Key, RecordId, Order>>;
+    using InternalNodePtr = NodePtr<InternalNode<Key, RecordId, Order, InternalOrder>>;
+    using LeafNodePtr = NodePtr<LeafNode<Key, RecordId, Order>>;
+
+    // Non-owning node pointers used while traversing. The NodePtrs in the tree own the
+    // nodes; a traversal runs inside an EpochGuard, which keeps unlinked nodes alive
+    // until it has finished, so it never touches a reference count.
+    using InternalNodeRef = InternalNode<Key, RecordId, Order, InternalOrder>*;
+    using LeafNodeRef = LeafNode<Key, RecordId, Order>*;
+    using NodeRef = std::variant<InternalNodeRef, LeafNodeRef, std::monostate>;
+
+    static_assert(Order >= 4, "BPlusTree requires Order >= 4 so that split halves stay non-empty");
+    static_assert(InternalOrder >= 4, "BPlusTree requires InternalOrder >= 4 so that split halves stay non-empty");
+
+    /**
+     * @brief One step of a root-to-leaf descent: the internal node that was
+     * visited and the index of the child that was taken from it.
+     */
+    struct PathEntry {
+        InternalNodeRef node;
+        size_t index;
+    };
+
+    using Path = DynamicArray<PathEntry>;
+
+    /**
+     * @brief Exclusive latches held by a writer on its way down the tree.
+     *
+     * Holds root_mutex_ and the internal nodes whose latch is still held. The writer
+     * drops all of them as soon as it latches a node that can absorb the change
+     * without splitting or underflowing. Anything still held is released on destruction.
+     */
+    struct WriteLatches {
+        std::unique_lock<OptimisticLatch> root_lock;
+        DynamicArray<InternalNodeRef> nodes;
+
+        void release_ancestors(Path& path);
+        ~WriteLatches();
+    };
+
+    enum class WriteOp { Insert, Remove };
 
-    mutable std::shared_mutex root_mutex_; 
+    // How much of the tree a writer latches: only the leaf, the unsafe part of the
+    // path (released at the first safe node), or the whole path
+    enum class Descent { Optimistic, Coupled, Pessimistic };
+
+    mutable OptimisticLatch root_mutex_; 
+
+    // Declared ahead of the nodes so that it is destroyed after them
+    NodeAllocator allocator_;
     
-    VariantNode<Key, RecordId, Order> root_;
+    VariantNode<Key, RecordId, Order, InternalOrder> root_;
+
+    // The last leaf while inserts keep appending to it, so that they can skip the descent
+    std::atomic<LeafNodeRef> append_hint_{nullptr};
+
+    // Number of retire() calls; a SearchHint is only trusted while it has not changed
+    std::atomic<uint64_t> retirements_{0};
+
+    // Optimistic attempts a reader makes before it falls back to shared latches
+    static constexpr size_t optimistic_read_attempts = 8;
+
+    // Keys whose descents find_many() interleaves; enough independent misses to keep
+    // the memory system busy without evicting the nodes prefetched for the next level
+    static constexpr size_t find_many_group = 16;
+
+    /**
+     * @brief State of an optimistic descent between two levels
+     */
+    struct OptimisticDescent {
+        const OptimisticLatch* parent;
+        uint64_t parent_version;
+        const VariantNode<Key, RecordId, Order, InternalOrder>* slot;  // the child slot to follow next
+    };
+
+    enum class DescentStep { Descended, Arrived, Restart };
+
+    /**
+     * @brief A node unlinked from the tree, tagged with the epoch it was retired in
+     */
+    struct RetiredNode {
+        VariantNode<Key, RecordId, Order, InternalOrder> node;
+        uint64_t epoch;
+    };
+
+    // Retired nodes are freed in batches once no traversal can still be inside them
+    static constexpr size_t reclaim_batch = 64;
+
+    DynamicArray<RetiredNode> retired_;
+    size_t reclaim_at_ = reclaim_batch;
+    std::mutex retired_mutex_;
     
-    size_t size_ = 0;
+    std::atomic<size_t> size_ = 0;
     
     compare comparator_; 
 
+    ConcurrencyMode mode_ = ConcurrencyMode::LatchCoupling;
 
-    void split_leaf(LeafNodePtr node);
-    void split_internal(InternalNodePtr node);
+    // SubtreeCounts::On: every internal node's counts_ is maintained
+    bool counted_ = false;
+
+
+    void split_leaf(LeafNodeRef node, Path& path, bool append = false);
+    void split_internal(InternalNodeRef node, Path& path, bool append = false);
+    LeafNodePtr split_leaf_node(LeafNodeRef leaf, bool append = false);
+    InternalNodePtr split_internal_node(InternalNodeRef node, Key& separator, bool append = false);
+    void grow_root(const Key& separator, const VariantNode<Key, RecordId, Order, InternalOrder>& right);
 
     bool is_less_or_eq(const Key& key1, const Key& key2) const;
 
-    void redistribute_nodes(VariantNode<Key, RecordId, Order>& lhs, VariantNode<Key, RecordId, Order>& rhs);
-    void merge_nodes(VariantNode<Key, RecordId, Order>& left, VariantNode<Key, RecordId, Order>& right);
-    void balance_after_remove(VariantNode<Key, RecordId, Order> node);
+    void redistribute_nodes(InternalNodeRef parent, size_t left_index);
+    void merge_nodes(InternalNodeRef parent, size_t left_index);
+    void balance_after_remove(NodeRef node, Path& path);
+
+    static size_t subtree_count(const VariantNode<Key, RecordId, Order, InternalOrder>& node);
+    static void refresh_counts(InternalNodeRef parent, size_t first, size_t last);
+    static void count_along_path(const Path& path, ptrdiff_t delta);
+    size_t count_before(const Key& key, bool inclusive) const;
+
+    size_t child_index(const InternalNode<Key, RecordId, Order, InternalOrder>& node, const Key& key) const;
+    size_t leaf_lower_bound(const LeafNode<Key, RecordId, Order>& leaf, size_t from, size_t to, const Key& key) const;
+
+    // Separators are cut down to their distinguishing bytes where keys sort like their bytes
+    static constexpr bool truncates_separators = KeyStem<Key>::enabled && prefix_searchable<Key, compare>;
+
+    Key separator_between(const Key& left, const Key& right) const;
+    size_t leaf_split_point(const LeafNode<Key, RecordId, Order>& leaf) const;
+    size_t internal_split_point(const InternalNode<Key, RecordId, Order, InternalOrder>& node) const;
+
+    template <typename Node>
+    bool moves_right(const Node& node, const Key& key) const;
+
+    template <typename InRange, typename Visitor>
+    size_t scan_while(const Key& from, InRange&& in_range, Visitor&& visitor);
+
+    static bool prefix_successor(std::string_view prefix, std::string& successor);
+
+    LeafNodeRef descend_shared(const Key* key, bool exclusive_leaf = false) const;
+    LeafNodeRef descend_blink(const Key* key, bool exclusive_leaf, Path* path) const;
+    LeafNodeRef find_leaf(const Key& key) const;
+    LeafNodeRef leftmost_leaf() const;
+    LeafNodeRef rightmost_leaf() const;
+    static LeafNodeRef next_leaf_shared(LeafNodeRef leaf, std::shared_lock<OptimisticLatch>& leaf_lock);
+
+    bool start_descent_optimistic(OptimisticDescent& descent) const;
+    DescentStep step_descent_optimistic(OptimisticDescent& descent, const Key& key,
+                                        const LeafNode<Key, RecordId, Order>*& leaf,
+                                        uint64_t& leaf_version) const;
+    bool find_leaf_optimistic(const Key& key, const LeafNode<Key, RecordId, Order>*& leaf,
+                              uint64_t& leaf_version) const;
+    template <typename Node>
+    bool move_right_optimistic(const Node*& node, const Key& key, uint64_t& version) const;
+    static bool next_leaf_optimistic(const LeafNode<Key, RecordId, Order>*& leaf, uint64_t& leaf_version);
+    bool find_optimistic(const Key& key, DynamicArray<RecordId>& result) const;
+    bool collect_optimistic(const Key& key, const LeafNode<Key, RecordId, Order>* leaf,
+                            uint64_t version, DynamicArray<RecordId>& result) const;
+    void find_group_optimistic(const Key* keys, size_t count, DynamicArray<RecordId>* results,
+                               bool* found) const;
+    static void prefetch_child(const VariantNode<Key, RecordId, Order, InternalOrder>* slot);
+    bool range_search_optimistic(const Key& from, const Key& to, DynamicArray<RecordId>& result) const;
+    void retire(VariantNode<Key, RecordId, Order, InternalOrder> node);
+    void reclaim_retired();
+
+    bool is_safe(WriteOp op, size_t node_size, bool is_leaf, bool is_root) const;
+    LeafNodeRef find_leaf_for_write(const Key& key, Path& path, WriteLatches& latches,
+                                    WriteOp op, bool pessimistic);
+    LeafNodeRef advance_path(Path& path, WriteLatches& latches);
+    bool remove_impl(const Key& key, Descent mode);
 
-    LeafNodePtr find_leaf(const Key& key);
-    SharedPtr<InternalNode<Key, RecordId, Order>> find_parent(const VariantNode<Key, RecordId, Order>& target);
+    template <typename T>
+    void insert_into_leaf(LeafNodeRef leaf, const Key& key, T&& id);
+
+    void collect_latched(const Key& key, LeafNodeRef leaf, std::shared_lock<OptimisticLatch>& leaf_lock,
+                         DynamicArray<RecordId>& result) const;
+
+    bool appends_to_last_leaf(const LeafNode<Key, RecordId, Order>& leaf, const Key& key) const;
+    void set_append_hint(LeafNodeRef leaf);
+    LeafNodeRef latch_append_hint(const Key& key);
+    LeafNodeRef latch_search_hint(SearchHint& hint, const Key& key, bool exclusive) const;
+    void remember_leaf(SearchHint* hint, LeafNodeRef leaf) const;
+
+    template <typename T>
+    void insert_coupled(const Key& key, T&& id, SearchHint* hint);
+    template <typename T>
+    void insert_blink(const Key& key, T&& id, SearchHint* hint);
+    void insert_into_parent_blink(NodeRef child, Key separator,
+                                  VariantNode<Key, RecordId, Order, InternalOrder> sibling, Path& path,
+                                  bool append = false);
+    InternalNodeRef find_parent_blink(const NodeRef& child, const Key& key) const;
+    void remove_blink(const Key& key);
+
+    LeafNodePtr make_leaf() { return allocator_.template make<LeafNode<Key, RecordId, Order>>(); }
+    InternalNodePtr make_internal() {
+        return allocator_.template make<InternalNode<Key, RecordId, Order, InternalOrder>>();
+    }
 
-    InternalNodePtr deep_copy_node(const InternalNodePtr& node);
-    void rebuild_leaf_links();
-    void collect_leaves(
-            const VariantNode<Key, RecordId, Order>& node,
-            DynamicArray<LeafNodePtr>& leaves);
+    static NodeRef ref_of(const VariantNode<Key, RecordId, Order, InternalOrder>& node);
+    static void lock_node(const NodeRef& node);
+    static void unlock_node(const NodeRef& node);
+
+    InternalNodePtr deep_copy_node(InternalNodeRef node);
+    void rebuild_sibling_links();
+
+    static size_t packed_node_count(size_t items, size_t capacity, double fill_factor);
+
+    using BatchEntries = std::vector<std::pair<Key, RecordId>>;
+
+    LeafNodeRef reverse_scan_start(const Key& bound, BatchEntries& entries,
+                                   LeafNodeRef& prev, uint64_t& version) const;
+
+    size_t batch_run_end(const LeafNode<Key, RecordId, Order>& leaf, const BatchEntries& batch,
+                         size_t first, size_t limit) const;
+    void merge_into_leaf(LeafNodeRef leaf, const BatchEntries& batch, size_t first, size_t last);
+    size_t insert_batch_run(const BatchEntries& batch, size_t first);
+    size_t insert_batch_run_blink(const BatchEntries& batch, size_t first);
 
   public:
 
-    BPlusTree() : root_(std::monostate{}), size_(0), comparator_() {}
+    /**
+     * @brief Whether find() and range_search() read without latching
+     *
+     * @details
+     * Optimistic readers may observe a node while a writer is changing it and only
+     * discard what they read afterwards, so this is limited to keys and record ids
+     * for which a torn copy is harmless.
+     */
+    static constexpr bool optimistic_reads =
+        std::is_trivially_copyable_v<Key> && std::is_trivially_copyable_v<RecordId>;
+
+    BPlusTree() : root_(nullptr), size_(0), comparator_() {}
+    explicit BPlusTree(ConcurrencyMode mode, SubtreeCounts counts = SubtreeCounts::Off);
+    explicit BPlusTree(std::pmr::memory_resource* resource,
+                       ConcurrencyMode mode = ConcurrencyMode::LatchCoupling,
+                       SubtreeCounts counts = SubtreeCounts::Off);
     BPlusTree(const BPlusTree& other);
     BPlusTree(BPlusTree&& other) noexcept;
 
@@ -141,41 +508,110 @@ class BPlusTree {
 
     template <typename T>
     void insert(const Key& key, T&& id);
+    template <typename T>
+    void insert(const Key& key, T&& id, SearchHint& hint);
     void remove(const Key& key);
 
+    template <typename ForwardIt>
+    void bulk_load(ForwardIt first, ForwardIt last, double fill_factor = 1.0);
+
+    void insert_batch(std::span<const std::pair<Key, RecordId>> batch);
+
+
+    /**
+     * @brief Continuation token for paged range queries
+     *
+     * @details
+     * Records where the previous page ended: the last key returned and how many
+     * entries with that key were returned so far, so a page can end in the middle of
+     * a run of duplicates. A default-constructed cursor starts at the lower bound.
+     */
+    struct RangeCursor {
+        std::optional<Key> last_key;
+        size_t duplicates = 0;
+        bool exhausted = false;  ///< Set once a page reaches the upper bound
+    };
 
     DynamicArray<RecordId> find(const Key& key);
+    DynamicArray<RecordId> find(const Key& key, SearchHint& hint);
+    DynamicArray<DynamicArray<RecordId>> find_many(std::span<const Key> keys);
     DynamicArray<RecordId> range_search(const Key& from, const Key& to);
-    DynamicArray<RecordId> prefix_search(const std::string& prefix);
+    DynamicArray<RecordId> range_search(const Key& from, const Key& to, size_t limit);
+    DynamicArray<RecordId> range_search(const Key& from, const Key& to, size_t limit, RangeCursor& cursor);
+    DynamicArray<RecordId> reverse_range_search(const Key& to, const Key& from,
+                                                size_t limit = std::numeric_limits<size_t>::max());
+    DynamicArray<RecordId> prefix_search(std::string_view prefix);
+
+    template <typename... Leading>
+    DynamicArray<RecordId> prefix_search(const CompositeKey<Leading...>& prefix);
     
     template <typename Predicate>
     DynamicArray<RecordId> find_if(Predicate pred);
 
+    template <typename Visitor>
+    size_t scan(const Key& from, const Key& to, Visitor&& visitor);
+
+    /**
+     * @brief Bidirectional iterator over the entries in key order
+     *
+     * @details
+     * Iterators hold a raw pointer to their leaf and keep neither a latch nor an
+     * EpochGuard, so they are only for a tree that no other thread writes to. As with
+     * std::vector, remove(), clear() and assignment to the tree invalidate every
+     * iterator: a merge may retire the leaf an iterator is in, and the leaf is freed
+     * as soon as no thread is inside a guard, so even in a single thread the next step
+     * could read freed memory. Inserts never free a leaf, but a split moves entries to
+     * a new one, so an iterator kept across inserts may skip or repeat entries. After
+     * changing the tree, take a new iterator, e.g. from lower_bound(); scan() and
+     * range_search() are the reads to use while other threads write.
+     */
     class Iterator {
       private:
 
-        LeafNodePtr current_node_;
+        LeafNodeRef current_node_;
         size_t current_index_; 
+        const BPlusTree* tree_;  // lets end() be decremented
+
+        void seek_past(const Key& key);
+
+        friend class BPlusTree;
 
       public:
-        Iterator(LeafNodePtr node = nullptr, size_t index = 0);
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = Pair<const Key&, RecordId&>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = Pair<const Key&, RecordId&>;
+
+        Iterator(LeafNodeRef node = nullptr, size_t index = 0, const BPlusTree* tree = nullptr);
 
         Iterator& operator++();
+        Iterator& operator--();
+        Iterator& seek(const Key& key);
         Pair<const Key&, RecordId&> operator*() const;
         bool operator==(const Iterator& other) const;
         bool operator!=(const Iterator& other) const;
     };
 
+    // Invalidated like Iterator
     class ConstIterator {
       private:
         
-        LeafNodePtr current_node_; 
+        LeafNodeRef current_node_; 
         size_t current_index_;
+        const BPlusTree* tree_;
 
       public:
-        ConstIterator(LeafNodePtr node = nullptr, size_t index = 0);
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = Pair<const Key&, const RecordId&>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = const Pair<const Key&, const RecordId&>;
+
+        ConstIterator(LeafNodeRef node = nullptr, size_t index = 0, const BPlusTree* tree = nullptr);
 
         ConstIterator& operator++();
+        ConstIterator& operator--();
         const Pair<const Key&, const RecordId&> operator*() const;
         bool operator==(const ConstIterator& other) const;
         bool operator!=(const ConstIterator& other) const;
@@ -226,6 +662,20 @@ class BPlusTree {
     Iterator begin();
     Iterator end();
 
+    size_t count(const Key& from, const Key& to);
+    size_t rank(const Key& key);
+    Iterator select(size_t k);
+
+    Iterator lower_bound(const Key& key);
+    Iterator lower_bound(const Key& key, SearchHint& hint);
+    Iterator upper_bound(const Key& key);
+    std::pair<Iterator, Iterator> equal_range(const Key& key);
+
+    using ReverseIterator = std::reverse_iterator<Iterator>;
+
+    ReverseIterator rbegin();
+    ReverseIterator rend();
+
     template <typename Predicate>
     FilterRange<Predicate> filter(Predicate pred);
     
@@ -233,12 +683,28 @@ class BPlusTree {
     TreeRange range();
 
     bool empty() const;
+    ConcurrencyMode mode() const { return mode_; }
     size_t height() const;
     double fill_factor() const;
 
     void clear();
 };
 
+
+
+/**
+ * @brief A BPlusTree whose leaf and internal fan-out come from a NodeSizePolicy
+ * 
+ * @details
+ * SizedBPlusTree<CompositeKey<std::string, int>, size_t, NodeSizePolicy<16384>> gets
+ * nodes of at most 16 KiB whatever the size of the key.
+ */
+
+template <typename Key, typename RecordId, typename Policy = NodeSizePolicy<4096>,
+          typename compare = std::less<Key>, typename NodeAllocator = HeapNodeAllocator>
+using SizedBPlusTree = BPlusTree<Key, RecordId, Policy::template leaf_order<Key, RecordId>, compare,
+                                 Policy::template internal_order<Key, RecordId>, NodeAllocator>;
+
 #include "Composite-Key.tpp"
 #include "BP-Tree.tpp"
 #include "Iterators.tpp"
@@ -1,31 +1,35 @@
 #include "BP-Tree.hpp"
 #include <memory>
 #include <algorithm>
+#include <array>
 #include <cstddef>
+#include <iterator>
 #include <mutex>
+#include <numeric>
 #include <stdexcept>
+#include <utility>
 
 
 
 // ---------------- INTERNAL NODE METHODS IMPLEMENTATION ----------------
 
-template <typename Key, typename RecordId, size_t Order>
-bool InternalNode<Key, RecordId, Order>::is_full() const {
-    return keys_.size() >= Order - 1;
+template <typename Key, typename RecordId, size_t Order, size_t InternalOrder>
+bool InternalNode<Key, RecordId, Order, InternalOrder>::is_full() const {
+    return keys_.size() >= InternalOrder - 1;
 }
 
-template <typename Key, typename RecordId, size_t Order>
-size_t InternalNode<Key, RecordId, Order>::size() const {
+template <typename Key, typename RecordId, size_t Order, size_t InternalOrder>
+size_t InternalNode<Key, RecordId, Order, InternalOrder>::size() const {
     return keys_.size();
 }
 
-template <typename Key, typename RecordId, size_t Order>
-void InternalNode<Key, RecordId, Order>::insert_key_at(size_t index, const Key& key) {
+template <typename Key, typename RecordId, size_t Order, size_t InternalOrder>
+void InternalNode<Key, RecordId, Order, InternalOrder>::insert_key_at(size_t index, const Key& key) {
     keys_.insert(keys_.begin() + index, key);
 }
 
-template <typename Key, typename RecordId, size_t Order>
-void InternalNode<Key, RecordId, Order>::insert_key_at(size_t index, Key&& key) {
+template <typename Key, typename RecordId, size_t Order, size_t InternalOrder>
+void InternalNode<Key, RecordId, Order, InternalOrder>::insert_key_at(size_t index, Key&& key) {
     keys_.insert(keys_.begin() + index, std::move(key));
 }
 
@@ -55,650 +59,3328 @@ RecordId LeafNode<Key, RecordId, Order>::get_record(size_t index) const {
 
 
 /**
- * @brief Locates the leaf node where a given key should be found in the B+ tree
+ * @brief Picks the child of an internal node whose subtree may hold a key
  * 
- * @param key The key value to search for
+ * @details
+ * Separator keys[i] bounds children[i] from above and children[i + 1] from below
+ * (inclusive on both sides, since duplicates may straddle a split), so the child
+ * to follow is the one at lower_bound of the key among the separators. This is
+ * the leftmost subtree that can contain the key.
+ */
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+size_t BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::child_index(
+    const InternalNode<Key, RecordId, Order, InternalOrder>& node, const Key& key) const {
+
+    auto it = key_lower_bound(node.keys_.begin(), node.keys_.end(), key, comparator_);
+    return it - node.keys_.begin();
+}
+
+
+/**
+ * @brief Position of the first key in [from, to) of a leaf that is not less than key
  * 
- * @return LeafNodePtr A pointer to the leaf node where the key should be located
+ * @details
+ * Searches the leaf's key prefixes when the keys have them and the comparator agrees
+ * with their order, and the keys themselves otherwise.
  */
 
-template <typename Key, typename RecordId, size_t Order, typename compare>
-typename BPlusTree<Key, RecordId, Order, compare>::LeafNodePtr 
-BPlusTree<Key, RecordId, Order, compare>::find_leaf(const Key& key) {
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+size_t BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::leaf_lower_bound(
+    const LeafNode<Key, RecordId, Order>& leaf, size_t from, size_t to, const Key& key) const {
 
-    // Check if the tree is empty (root is monostate)
-    if (std::holds_alternative<std::monostate>(root_)) {
-        return nullptr;
-    }
-    
-    // If root is a leaf node, return it directly
-    if (std::holds_alternative<LeafNodePtr>(root_)) {
-        return std::get<LeafNodePtr>(root_);
+    if constexpr (prefix_searchable<Key, compare>) {
+        return leaf.keys_.lower_bound(from, to, key, comparator_);
+    } else {
+        auto keys = leaf.keys_.begin();
+        return key_lower_bound(keys + from, keys + to, key, comparator_) - keys;
     }
+}
 
-    // Get the root as internal node to start traversal
-    auto current = std::get<InternalNodePtr>(root_);
-    while (true) {
-        // Use binary search to find the first key greater than or equal to target key
-        auto it = std::lower_bound(current->keys_.begin(),
-                                 current->keys_.end(),
-                                 key,
-                                 comparator_);
-        // Calculate the index where the key should be inserted
-        size_t index = it - current->keys_.begin();
-        
-        // If the key is greater than all keys in node, use the last child
-        if (index == current->keys_.size()) {
-            index--;
-        }
-        
-        // Get the appropriate child node
-        auto& child = current->children_[index];
-        
-        // If child is a leaf node, we've reached our destination
-        if (std::holds_alternative<LeafNodePtr>(child)) {
-            return std::get<LeafNodePtr>(child);
+
+/**
+ * @brief The key that goes up to the parent between two neighbouring leaves
+ * 
+ * @param left The last key of the left leaf
+ * @param right The first key of the right leaf
+ * 
+ * @details
+ * Any key that is not less than left and not greater than right routes searches
+ * correctly. With truncates_separators, this is the shortest one, which keeps the
+ * separators in internal nodes short: for strings, often short enough to live inline.
+ */
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+Key BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::separator_between(
+    const Key& left, const Key& right) const {
+
+    if constexpr (truncates_separators) {
+        if (comparator_(left, right)) {
+            return KeyStem<Key>::separator(left, right);
         }
-        // Otherwise, continue traversing down the tree
-        current = std::get<InternalNodePtr>(child);
     }
+    return right;
 }
 
 
-template <typename Key, typename RecordId, size_t Order, typename compare>
-bool BPlusTree<Key, RecordId, Order, compare>::is_less_or_eq(const Key& key1, const Key& key2) const {
-    return !comparator_(key2, key1);
-} 
+/**
+ * @brief Where to split a full leaf: the first entry of the new right sibling
+ * 
+ * @details
+ * The middle, or with truncates_separators the position near the middle (within a
+ * sixteenth of the leaf on either side) whose separator is shortest, so that short
+ * separators go up where the keys allow it.
+ */
 
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+size_t BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::leaf_split_point(
+    const LeafNode<Key, RecordId, Order>& leaf) const {
+
+    const auto& keys = leaf.keys_;
+    size_t mid = keys.size() / 2;
+
+    if constexpr (truncates_separators) {
+        size_t window = keys.size() / 16;
+        size_t best = mid;
+        size_t best_length = KeyStem<Key>::shared(keys[mid - 1], keys[mid]);
+        for (size_t distance = 1; distance <= window; ++distance) {
+            for (size_t candidate : {mid - distance, mid + distance}) {
+                size_t length = KeyStem<Key>::shared(keys[candidate - 1], keys[candidate]);
+                if (length < best_length) {
+                    best = candidate;
+                    best_length = length;
+                }
+            }
+        }
+        return best;
+    }
+    return mid;
+}
 
 
 /**
- * @brief Inserts a key-value pair into the B+ tree
- * 
- * @param key The key to insert
- * @param id The record ID associated with the key
+ * @brief Where to split a full internal node: the index of the key that moves up
  * 
  * @details
- * This method handles the insertion of new key-value pairs into the B+ tree.
- * It handles the following cases:
- * 1. Insertion into an empty tree
- * 2. Insertion into an existing leaf node
- * 3. Splitting of full nodes when necessary
+ * The middle, or with truncates_separators the shortest key near the middle (see
+ * leaf_split_point()).
  */
 
-template <typename Key, typename RecordId, size_t Order, typename compare>
-template <typename T>
-void BPlusTree<Key, RecordId, Order, compare>::insert(const Key& key, T&& id) {
-
-    // Acquire exclusive lock for the root 
-    std::unique_lock<std::shared_mutex> write_lock(root_mutex_);
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+size_t BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::internal_split_point(
+    const InternalNode<Key, RecordId, Order, InternalOrder>& node) const {
 
-    // Handle insertion into empty tree
-    if (std::holds_alternative<std::monostate>(root_)) {
-        // Create new leaf node as root
-        auto new_leaf = make_shared<LeafNode<Key, RecordId, Order>>();
+    const auto& keys = node.keys_;
+    size_t mid = keys.size() / 2;
 
-        new_leaf->keys_.push_back(key);
-        new_leaf->values_.push_back(std::forward<T>(id));  // Perfect forward the record ID
-        
-        root_ = new_leaf;
-        size_++;
-        return;
+    if constexpr (truncates_separators) {
+        size_t window = keys.size() / 16;
+        size_t best = mid;
+        for (size_t distance = 1; distance <= window; ++distance) {
+            for (size_t candidate : {mid - distance, mid + distance}) {
+                if (KeyStem<Key>::length(keys[candidate]) < KeyStem<Key>::length(keys[best])) {
+                    best = candidate;
+                }
+            }
+        }
+        return best;
     }
+    return mid;
+}
 
-    // Find the appropriate leaf node for insertion
-    LeafNodePtr leaf = find_leaf(key);
-    if (!leaf) {
-        throw std::runtime_error("Failed to find leaf node");
-    }
 
-    std::unique_lock<std::shared_mutex> leaf_lock(leaf->mutex_);
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+typename BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::NodeRef
+BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::ref_of(const VariantNode<Key, RecordId, Order, InternalOrder>& node) {
+    if (node.is_leaf()) {
+        return node.leaf();
+    }
+    if (node.is_internal()) {
+        return node.internal();
+    }
+    return std::monostate{};
+}
 
-    // Find the position where the key should be inserted
-    auto it = std::lower_bound(leaf->keys_.begin(), leaf->keys_.end(),key, comparator_);
-    size_t insert_pos = it - leaf->keys_.begin();
 
-    // Check for duplicate keys
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+void BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::lock_node(const NodeRef& node) {
+    if (std::holds_alternative<LeafNodeRef>(node)) {
+        std::get<LeafNodeRef>(node)->mutex_.lock();
+    } else if (std::holds_alternative<InternalNodeRef>(node)) {
+        std::get<InternalNodeRef>(node)->mutex_.lock();
+    }
+}
 
-    // Insert the key-value pair at the appropriate position
-    leaf->keys_.insert(leaf->keys_.begin() + insert_pos, key);
-    leaf->values_.insert(leaf->values_.begin() + insert_pos, std::forward<T>(id));
-    size_++;
 
-    // If the leaf node is full after insertion, split it
-    if (leaf->size() >= Order) {
-        split_leaf(leaf);
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+void BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::unlock_node(const NodeRef& node) {
+    if (std::holds_alternative<LeafNodeRef>(node)) {
+        std::get<LeafNodeRef>(node)->mutex_.unlock();
+    } else if (std::holds_alternative<InternalNodeRef>(node)) {
+        std::get<InternalNodeRef>(node)->mutex_.unlock();
     }
 }
 
 
 /**
- * @brief Splits a full leaf node into two nodes in the B+ tree
- * 
- * @param leaf Pointer to the leaf node that needs to be split
+ * @brief Tells whether a key lies beyond a node's high key
  * 
  * @details
- * This method handles the splitting of a full leaf node
- * The process includes:
- * 1. Creating a new leaf node
- * 2. Redistributing the keys and values
- * 3. Updating the linked list of leaf nodes
- * 4. Handling the parent node modifications
- * 
- * @note This method assumes the leaf node is already locked by the caller
+ * Separators bound both neighbours inclusively, so only a key strictly greater than
+ * the high key can be missing from the node; an equal key is found here first.
  */
 
-template <typename Key, typename RecordId, size_t Order, typename compare>
-void BPlusTree<Key, RecordId, Order, compare>::split_leaf(LeafNodePtr leaf) {
-
-    // Create a new leaf node to hold half of the elements
-    auto new_leaf = make_shared<LeafNode<Key, RecordId, Order>>();
-    
-    size_t mid = leaf->keys_.size() / 2;
-    
-    // Copy the second half of keys and values to the new leaf
-    new_leaf->keys_.assign(leaf->keys_.begin() + mid, leaf->keys_.end());
-    new_leaf->values_.assign(leaf->values_.begin() + mid, leaf->values_.end());
-    
-    // Resize the original leaf to keep only the first half
-    leaf->keys_.resize(mid);
-    leaf->values_.resize(mid);
-    
-    // Update the linked list pointers
-    // new_leaf->next_ points to whatever leaf->next_ was pointing to
-    new_leaf->next_ = leaf->next_;
-    // leaf->next_ now points to the new leaf
-    leaf->next_ = new_leaf;
-
-    // Handle the case when we're splitting the root leaf node
-    if (std::holds_alternative<LeafNodePtr>(root_) && 
-        std::get<LeafNodePtr>(root_) == leaf) {
-     
-        // Create new internal node as the root
-        auto new_root = make_shared<InternalNode<Key, RecordId, Order>>();
-        // Add the first key of the new leaf as the splitting key
-        new_root->keys_.push_back(new_leaf->keys_.front());
-        
-        // Set up the children pointers
-        new_root->children_.push_back(leaf);
-        new_root->children_.push_back(new_leaf);
-        // Update the root
-        root_ = new_root;
-    
-    } else {
-        // Handle the case when we're splitting a non-root leaf node
-        auto parent = find_parent(leaf);
-    
-        if (parent) {
-            // Find the position where the new key should be inserted in the parent
-            size_t insert_pos = std::lower_bound(parent->keys_.begin(), 
-                                               parent->keys_.end(), 
-                                               new_leaf->keys_.front(), 
-                                               comparator_) - parent->keys_.begin();
-            
-            // Insert the new key and child pointer into the parent
-            parent->keys_.insert(parent->keys_.begin() + insert_pos, 
-                               new_leaf->keys_.front());
-            parent->children_.insert(parent->children_.begin() + insert_pos + 1, 
-                                   new_leaf);
-
-            // If the parent becomes full after insertion, split it
-            if (parent->is_full()) {
-                split_internal(parent);
-            }
-        }
-    }
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+template <typename Node>
+bool BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::moves_right(const Node& node, const Key& key) const {
+    return node.has_high_key_ && comparator_(node.high_key_, key);
 }
 
 
 /**
- * @brief Splits a full internal node into two nodes in the B+ tree
+ * @brief Descends from the root to a leaf with shared latches
  * 
- * @param node Pointer to the internal node that needs to be split
+ * @param key The key to descend towards, or nullptr for the leftmost leaf
+ * @param exclusive_leaf Latch the leaf exclusively instead of shared
+ * 
+ * @return LeafNodeRef The leaf reached, with its latch held by the caller,
+ *         or nullptr if the tree is empty
  * 
  * @details
- * This method handles the splitting of a full internal node.
- * The process includes:
- * 1. Creating a new internal node
- * 2. Moving half of the keys and children to the new node
- * 3. Promoting the middle key to the parent
- * 4. Handling special case when splitting the root
+ * With latch coupling the latch of a child is taken before the latch of its parent is
+ * released, so a reader never observes a node in the middle of a split or merge.
+ * root_mutex_ is only held until the root node itself is latched. B-link trees are
+ * descended by descend_blink() instead.
  */
 
-template <typename Key, typename RecordId, size_t Order, typename compare>
-void BPlusTree<Key, RecordId, Order, compare>::split_internal(InternalNodePtr node) {
-
-    // Create a new internal node to hold right half of elements
-    auto new_node = make_shared<InternalNode<Key, RecordId, Order>>();
-    
-    // Find the middle point and the key that will be promoted
-    size_t mid = node->keys_.size() / 2;
-    Key mid_key = node->keys_[mid];  // This key will be promoted to the parent
-    
-    // Move keys and children after the middle to the new node
-    // !!!: For internal nodes, middle key goes up, not copied
-    new_node->keys_.assign(node->keys_.begin() + mid + 1, node->keys_.end());
-    new_node->children_.assign(node->children_.begin() + mid + 1, node->children_.end());
-    
-    // Resize the original node to remove transferred elements
-    node->keys_.resize(mid);  // Remove middle key and everything after
-    node->children_.resize(mid + 1);  // Keep one more child than keys
-
-    // Handle the case when splitting the root internal node
-    if (std::holds_alternative<InternalNodePtr>(root_) && 
-        std::get<InternalNodePtr>(root_) == node) {
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+typename BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::LeafNodeRef 
+BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::descend_shared(const Key* key, bool exclusive_leaf) const {
 
-        auto new_root = make_shared<InternalNode<Key, RecordId, Order>>();
-        
-        // Add the promoted middle key
-        new_root->keys_.push_back(mid_key);
-        
-        // Set up the children pointers
-        new_root->children_.push_back(node);
-        new_root->children_.push_back(new_node);
-        
-        // Update the root
-        root_ = new_root;
-    
-    } else {
-        // Handle the case when splitting a non-root internal node
-        auto parent = find_parent(node);
-        if (parent) {
-            // Find the position where the promoted key should go in the parent
-            size_t insert_pos = std::lower_bound(parent->keys_.begin(), 
-                                               parent->keys_.end(), 
-                                               mid_key, 
-                                               comparator_) - parent->keys_.begin();
-            
-            // Insert the promoted key and new node pointer into the parent
-            parent->keys_.insert(parent->keys_.begin() + insert_pos, mid_key);
-            parent->children_.insert(parent->children_.begin() + insert_pos + 1, 
-                                   new_node);
-
-            // If the parent becomes full after insertion, split it recursively
-            if (parent->is_full()) {
-                split_internal(parent);
-            }
-        }
+    if (mode_ == ConcurrencyMode::BLink) {
+        return descend_blink(key, exclusive_leaf, nullptr);
     }
-}
 
+    auto latch_leaf = [exclusive_leaf](LeafNodeRef leaf) {
+        if (exclusive_leaf) {
+            leaf->mutex_.lock();
+        } else {
+            leaf->mutex_.lock_shared();
+        }
+    };
 
-template <typename Key, typename RecordId, size_t Order, typename compare>
-typename BPlusTree<Key, RecordId, Order, compare>::InternalNodePtr
-BPlusTree<Key, RecordId, Order, compare>::find_parent(const VariantNode<Key, RecordId, Order>& target) {
+    std::shared_lock root_lock(root_mutex_);
 
-    // If tree is empty or target is root, return nullptr
-    if (std::holds_alternative<std::monostate>(root_) || root_ == target) {
+    // Check if the tree is empty (no root node)
+    if (!root_) {
         return nullptr;
     }
-    
-    // Make sure root is an internal node
-    if (!std::holds_alternative<InternalNodePtr>(root_)) {
-        return nullptr;
+
+    // If root is a leaf node, return it directly
+    if (root_.is_leaf()) {
+        LeafNodeRef leaf = root_.leaf();
+        latch_leaf(leaf);
+        return leaf;
     }
-    
-    auto current = std::get<InternalNodePtr>(root_);
-    InternalNodePtr parent = nullptr;
-    
-    // Keep searching until we find the parent or exhaust all possibilities
-    while (current) {
-        bool found = false;
-        
-        // Search through all children of current node
-        for (size_t i = 0; i < current->children_.size(); ++i) {
-            if (current->children_[i] == target) {
-                return current;  // Found the parent
-            }
-            
-            // If child is internal node, we need to search deeper
-            if (std::holds_alternative<InternalNodePtr>(current->children_[i])) {
-                parent = current;
-                current = std::get<InternalNodePtr>(current->children_[i]);
-                found = true;
-                break;
-            }
-        }
-        
-        // If we didn't find a path to continue searching, stop
-        if (!found) {
-            break;
+
+    InternalNodeRef current = root_.internal();
+    current->mutex_.lock_shared();
+    root_lock.unlock();
+
+    while (true) {
+        const auto& child = current->children_[key ? child_index(*current, *key) : 0];
+
+        // Latch the child before letting go of the parent
+        if (child.is_leaf()) {
+            LeafNodeRef leaf = child.leaf();
+            latch_leaf(leaf);
+            current->mutex_.unlock_shared();
+            return leaf;
         }
+
+        InternalNodeRef next = child.internal();
+        next->mutex_.lock_shared();
+        current->mutex_.unlock_shared();
+        current = next;
     }
-    
-    return nullptr;  // Parent not found
 }
 
 
 /**
- * @brief Removes a key and its associated value from the B+ tree
+ * @brief Descends a B-link tree holding one latch at a time
  * 
- * @param key The key to remove
+ * @param key The key to descend towards, or nullptr for the leftmost leaf
+ * @param exclusive_leaf Latch the leaf exclusively instead of shared
+ * @param path If not null, receives the internal node visited on each level
+ * 
+ * @return LeafNodeRef The leaf that covers the key, latched, or nullptr if the tree is empty
  * 
  * @details
- * This method handles the removal of a key-value pair, including:
- * 1. Finding the appropriate leaf node
- * 2. Removing the key-value pair
- * 3. Handling underflow situations through rebalancing
- * 4. Special handling for root node
+ * A parent is released before its child is latched. If the child split in between,
+ * the key now lies beyond its high key and the descent follows the right sibling
+ * link, latching left to right. The leftmost descent never has to move right.
  */
 
-template <typename Key, typename RecordId, size_t Order, typename compare>
-void BPlusTree<Key, RecordId, Order, compare>::remove(const Key& key) {
-
-    std::unique_lock write_lock(root_mutex_);
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+typename BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::LeafNodeRef 
+BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::descend_blink(const Key* key, bool exclusive_leaf, Path* path) const {
 
-    // Return if tree is empty
-    if (std::holds_alternative<std::monostate>(root_)) {
-        return;
+    NodeRef node;
+    {
+        std::shared_lock root_lock(root_mutex_);
+        node = ref_of(root_);
     }
 
-    // Find the leaf node containing the key
-    LeafNodePtr leaf = find_leaf(key);
-    if (!leaf) {
-        return;
-    }
+    while (std::holds_alternative<InternalNodeRef>(node)) {
+        InternalNodeRef current = std::get<InternalNodeRef>(node);
+        std::shared_lock<OptimisticLatch> node_lock(current->mutex_);
 
-    // Lock the leaf node for exclusive access
-    std::unique_lock leaf_lock(leaf->mutex_);
+        while (key && moves_right(*current, *key)) {
+            InternalNodeRef right = current->right_.get();
+            std::shared_lock<OptimisticLatch> right_lock(right->mutex_);
+            node_lock.swap(right_lock);
+            current = right;
+        }
 
-    // Find the position of the key in the leaf
-    auto it = std::lower_bound(leaf->keys_.begin(), leaf->keys_.end(), key, comparator_);
-    
-    // Return if key doesn't exist
-    if (it == leaf->keys_.end() || comparator_(key, *it) || comparator_(*it, key)) {
-        return; 
+        size_t index = key ? child_index(*current, *key) : 0;
+        if (path) {
+            path->push_back({current, index});
+        }
+        node = ref_of(current->children_[index]);
     }
 
-    // Calculate position and remove key-value pair
-    size_t remove_pos = it - leaf->keys_.begin();
-    leaf->keys_.erase(leaf->keys_.begin() + remove_pos);
-    leaf->values_.erase(leaf->values_.begin() + remove_pos);
-    --size_;
+    if (!std::holds_alternative<LeafNodeRef>(node)) {
+        return nullptr;
+    }
 
-    // Handle case where root becomes empty
-    if (std::holds_alternative<LeafNodePtr>(root_) && leaf->keys_.empty()) {
-        root_ = std::monostate{};
-        return;
+    LeafNodeRef leaf = std::get<LeafNodeRef>(node);
+    if (exclusive_leaf) {
+        leaf->mutex_.lock();
+    } else {
+        leaf->mutex_.lock_shared();
     }
 
-    // Check if the leaf needs rebalancing
-    const size_t min_size = (Order - 1) / 2;
-    if (leaf->keys_.size() < min_size) {
-        balance_after_remove(leaf);
+    while (key && moves_right(*leaf, *key)) {
+        LeafNodeRef next = leaf->next_.get();
+        if (exclusive_leaf) {
+            next->mutex_.lock();
+            leaf->mutex_.unlock();
+        } else {
+            next->mutex_.lock_shared();
+            leaf->mutex_.unlock_shared();
+        }
+        leaf = next;
     }
+
+    return leaf;
 }
 
 
 /**
- * @brief Balances a node (leaf or internal) after removal
+ * @brief Locates the leaf node where a given key should be found in the B+ tree
  * 
- * @param node The variant node that needs balancing
+ * @param key The key value to search for
  * 
- * @details
- * This method provides a balancing algorithm that works with both, handling redistribution and merging as needed.
+ * @return LeafNodeRef The leftmost leaf that may hold the key, shared-latched;
+ *         the caller adopts and releases the latch
  */
 
-template <typename Key, typename RecordId, size_t Order, typename compare>
-void BPlusTree<Key, RecordId, Order, compare>::balance_after_remove(VariantNode<Key, RecordId, Order> node) {
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+typename BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::LeafNodeRef 
+BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::find_leaf(const Key& key) const {
+    return descend_shared(&key);
+}
 
-    // Skip if node is empty
-    if (std::holds_alternative<std::monostate>(node)) {
-        return;
-    }
 
-    // Find parent node
-    auto parent = find_parent(node);
-    if (!parent) {
-        return;
-    }
+/**
+ * @brief Follows the leftmost child pointers from the root down to the first leaf
+ * 
+ * @return LeafNodeRef The first leaf in key order, shared-latched, or nullptr for an empty tree
+ */
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+typename BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::LeafNodeRef 
+BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::leftmost_leaf() const {
+    return descend_shared(nullptr);
+}
+
+
+/**
+ * @brief Follows the rightmost child pointers from the root down to the last leaf
+ * 
+ * @return LeafNodeRef The last leaf in key order, shared-latched, or nullptr for an empty tree
+ * 
+ * @details
+ * Latches are taken the same way as in descend_shared(): coupled top-down with latch
+ * coupling, one at a time and moving right past splits in a B-link tree. Either way
+ * the walk ends by following next_, so a leaf split off the last one is not missed.
+ */
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+typename BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::LeafNodeRef 
+BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::rightmost_leaf() const {
+
+    LeafNodeRef leaf = nullptr;
 
-    // Find node's index in parent's children
-    size_t node_idx = 0;
-    for (; node_idx < parent->children_.size(); ++node_idx) {
-        if (parent->children_[node_idx] == node) {
-            break;
+    if (mode_ == ConcurrencyMode::BLink) {
+        NodeRef node;
+        {
+            std::shared_lock root_lock(root_mutex_);
+            node = ref_of(root_);
         }
-    }
 
-    // Try to redistribute with left sibling
-    if (node_idx > 0) {
-        auto& left_sibling = parent->children_[node_idx - 1];
-    
-        if (std::holds_alternative<LeafNodePtr>(left_sibling)) {
-            auto leaf = std::get<LeafNodePtr>(left_sibling);
-        
-            if (leaf->keys_.size() > (Order - 1) / 2) {
-                redistribute_nodes(left_sibling, node);
-                return;
+        while (std::holds_alternative<InternalNodeRef>(node)) {
+            InternalNodeRef current = std::get<InternalNodeRef>(node);
+            std::shared_lock<OptimisticLatch> node_lock(current->mutex_);
+
+            while (current->right_) {
+                InternalNodeRef right = current->right_.get();
+                std::shared_lock<OptimisticLatch> right_lock(right->mutex_);
+                node_lock.swap(right_lock);
+                current = right;
             }
+            node = ref_of(current->children_.back());
         }
-    }
 
+        if (!std::holds_alternative<LeafNodeRef>(node)) {
+            return nullptr;
+        }
+        leaf = std::get<LeafNodeRef>(node);
+        leaf->mutex_.lock_shared();
+
+    } else {
+        std::shared_lock root_lock(root_mutex_);
 
+        if (!root_) {
+            return nullptr;
+        }
 
-    // Try to redistribute with right sibling
-    if (node_idx < parent->children_.size() - 1) {
-        auto& right_sibling = parent->children_[node_idx + 1];
-        
-        if (std::holds_alternative<LeafNodePtr>(right_sibling)) {
-            auto leaf = std::get<LeafNodePtr>(right_sibling);
-        
-            if (leaf->keys_.size() > (Order - 1) / 2) {
-                redistribute_nodes(node, right_sibling);
-                return;
+        if (root_.is_leaf()) {
+            leaf = root_.leaf();
+            leaf->mutex_.lock_shared();
+        } else {
+            InternalNodeRef current = root_.internal();
+            current->mutex_.lock_shared();
+            root_lock.unlock();
+
+            while (!leaf) {
+                const auto& child = current->children_.back();
+                if (child.is_leaf()) {
+                    leaf = child.leaf();
+                    leaf->mutex_.lock_shared();
+                } else {
+                    InternalNodeRef next = child.internal();
+                    next->mutex_.lock_shared();
+                    current->mutex_.unlock_shared();
+                    current = next;
+                    continue;
+                }
+                current->mutex_.unlock_shared();
             }
         }
     }
 
-    // If redistribution isn't possible, merge with a sibling
-    if (node_idx > 0) {
-        merge_nodes(parent->children_[node_idx - 1], node);
+    while (leaf->next_) {
+        LeafNodeRef next = leaf->next_.get();
+        next->mutex_.lock_shared();
+        leaf->mutex_.unlock_shared();
+        leaf = next;
+    }
+    return leaf;
+}
+
+
+/**
+ * @brief Moves a shared leaf latch to the next leaf in key order
+ * 
+ * @param leaf The leaf currently latched through leaf_lock
+ * @param leaf_lock Lock owning the shared latch; it owns the next leaf's latch afterwards
+ * 
+ * @return LeafNodeRef The next leaf, or nullptr (with the latch released) at the end of the chain
+ * 
+ * @details
+ * Leaves are always latched left to right, which is what keeps scans deadlock-free
+ * against writers.
+ */
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+typename BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::LeafNodeRef 
+BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::next_leaf_shared(
+    LeafNodeRef leaf, std::shared_lock<OptimisticLatch>& leaf_lock) {
+
+    LeafNodeRef next = leaf->next_.get();
+    if (!next) {
+        leaf_lock.unlock();
+        return nullptr;
+    }
+
+    // Latch the next leaf first; the previous latch is released when next_lock goes out of scope
+    std::shared_lock next_lock(next->mutex_);
+    leaf_lock.swap(next_lock);
+    return next;
+}
+
+
+// ---------------- OPTIMISTIC READS ----------------
+//
+// Optimistic readers take no latch. They snapshot a node's version, read the node and
+// validate the version afterwards. A child pointer is only followed once its parent has
+// been validated. With latch coupling the parent is validated again after the child's
+// version has been read, so a split or merge that completes in between is noticed; a
+// B-link tree instead moves right past a child that split. Any failed validation
+// makes the caller restart. Nodes unlinked by writers are only freed once no reader
+// can be inside them any more (see retire()), so a stale pointer always refers to
+// live memory.
+//
+// Node arrays are accessed through a begin() snapshot plus index, so a concurrent
+// writer can never make a loop run past the element count it started with.
+
+
+/**
+ * @brief Starts an optimistic descent at the root
+ * 
+ * @return false if a writer is replacing the root and the descent must be restarted
+ */
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+bool BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::start_descent_optimistic(OptimisticDescent& descent) const {
+
+    // root_mutex_ guards root_ the same way a node guards its children
+    descent.parent = &root_mutex_;
+    descent.slot = &root_;
+    return descent.parent->read_version(descent.parent_version);
+}
+
+
+/**
+ * @brief Moves an optimistic descent one level down
+ * 
+ * @param descent The descent so far; receives the child slot on the next level
+ * @param key The key to descend towards
+ * @param leaf Receives the leaf once it is reached, or nullptr if the tree is empty
+ * @param leaf_version Receives the version the leaf had when it was reached
+ * 
+ * @return Whether the descent goes on, has arrived or has to be restarted
+ * 
+ * @details
+ * Descending one level at a time lets find_many() interleave the descents of
+ * several keys.
+ */
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+typename BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::DescentStep 
+BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::step_descent_optimistic(
+    OptimisticDescent& descent, const Key& key,
+    const LeafNode<Key, RecordId, Order>*& leaf, uint64_t& leaf_version) const {
+
+    leaf = descent.slot->leaf();
+    const InternalNode<Key, RecordId, Order, InternalOrder>* internal = leaf ? nullptr : descent.slot->internal();
+
+    // The pointer may be torn until the parent is known to be unchanged
+    if (!descent.parent->validate(descent.parent_version)) {
+        return DescentStep::Restart;
+    }
+    if (!internal && !leaf) {
+        return DescentStep::Arrived;
+    }
+
+    uint64_t child_version;
+    if (!(leaf ? leaf->mutex_ : internal->mutex_).read_version(child_version)) {
+        return DescentStep::Restart;
+    }
+
+    if (mode_ == ConcurrencyMode::BLink) {
+        bool moved = leaf ? move_right_optimistic(leaf, key, child_version)
+                          : move_right_optimistic(internal, key, child_version);
+        if (!moved) {
+            return DescentStep::Restart;
+        }
+    } else if (!descent.parent->validate(descent.parent_version)) {
+        return DescentStep::Restart;
+    }
+
+    if (leaf) {
+        leaf_version = child_version;
+        return DescentStep::Arrived;
+    }
+
+    auto keys = internal->keys_.begin();
+    size_t key_count = internal->keys_.size();
+    size_t index = key_lower_bound(keys, keys + key_count, key, comparator_) - keys;
+    if (index >= internal->children_.size()) {
+        return DescentStep::Restart;
+    }
+
+    descent.slot = &*(internal->children_.begin() + index);
+    descent.parent = &internal->mutex_;
+    descent.parent_version = child_version;
+    return DescentStep::Descended;
+}
+
+
+/**
+ * @brief Descends to the leaf that may hold a key without taking any latch
+ * 
+ * @param key The key to search for
+ * @param leaf Receives the leaf, or nullptr if the tree is empty
+ * @param leaf_version Receives the version the leaf had when it was reached
+ * 
+ * @return false if a concurrent write was detected and the descent must be restarted
+ */
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+bool BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::find_leaf_optimistic(
+    const Key& key, const LeafNode<Key, RecordId, Order>*& leaf, uint64_t& leaf_version) const {
+
+    OptimisticDescent descent;
+    if (!start_descent_optimistic(descent)) {
+        return false;
+    }
+
+    while (true) {
+        switch (step_descent_optimistic(descent, key, leaf, leaf_version)) {
+            case DescentStep::Descended:
+                break;
+            case DescentStep::Arrived:
+                return true;
+            case DescentStep::Restart:
+                return false;
+        }
+    }
+}
+
+
+/**
+ * @brief Follows right sibling links while a key lies beyond the node's high key
+ * 
+ * @param node The node reached so far; receives the node that covers the key
+ * @param key The key being searched for
+ * @param version The version read from node; receives the version of the final node
+ * 
+ * @return false if a node changed while it was inspected and the read must be restarted
+ */
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+template <typename Node>
+bool BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::move_right_optimistic(
+    const Node*& node, const Key& key, uint64_t& version) const {
+
+    while (true) {
+        bool beyond = moves_right(*node, key);
+        const Node* right = node->right_sibling().get();
+        if (!node->mutex_.validate(version)) {
+            return false;
+        }
+        if (!beyond) {
+            return true;
+        }
+        if (!right->mutex_.read_version(version)) {
+            return false;
+        }
+        node = right;
+    }
+}
+
+
+/**
+ * @brief Moves an optimistic read to the next leaf in key order
+ * 
+ * @return false if the current leaf changed and the read must be restarted;
+ *         leaf is set to nullptr at the end of the chain
+ */
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+bool BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::next_leaf_optimistic(
+    const LeafNode<Key, RecordId, Order>*& leaf, uint64_t& leaf_version) {
+
+    const LeafNode<Key, RecordId, Order>* next = leaf->next_.get();
+    if (!leaf->mutex_.validate(leaf_version)) {
+        return false;
+    }
+
+    uint64_t next_version = 0;
+    if (next && (!next->mutex_.read_version(next_version) || !leaf->mutex_.validate(leaf_version))) {
+        return false;
+    }
+
+    leaf = next;
+    leaf_version = next_version;
+    return true;
+}
+
+
+/**
+ * @brief One optimistic attempt at find()
+ * 
+ * @return false if the attempt was invalidated; result then holds garbage
+ */
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+bool BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::find_optimistic(
+    const Key& key, DynamicArray<RecordId>& result) const {
+
+    const LeafNode<Key, RecordId, Order>* leaf;
+    uint64_t version;
+    return find_leaf_optimistic(key, leaf, version) && collect_optimistic(key, leaf, version, result);
+}
+
+
+/**
+ * @brief Collects the ids stored under a key, starting at a leaf reached optimistically
+ * 
+ * @return false if a leaf changed while it was read; result then holds garbage
+ */
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+bool BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::collect_optimistic(
+    const Key& key, const LeafNode<Key, RecordId, Order>* leaf, uint64_t version,
+    DynamicArray<RecordId>& result) const {
+
+    while (leaf) {
+        auto keys = leaf->keys_.begin();
+        auto values = leaf->values_.begin();
+        size_t count = std::min(leaf->keys_.size(), leaf->values_.size());
+
+        size_t index = leaf_lower_bound(*leaf, 0, count, key);
+        for (; index < count; ++index) {
+            if (comparator_(key, keys[index])) {
+                return leaf->mutex_.validate(version);
+            }
+            result.push_back(values[index]);
+        }
+
+        // A run of duplicates may continue into the next leaf
+        if (!next_leaf_optimistic(leaf, version)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+/**
+ * @brief Prefetches the node a descent is about to visit
+ * 
+ * @details
+ * The slot may still be torn, but a prefetch never faults, so the worst a stale
+ * pointer costs is a wasted cache line. The latch and the key array are fetched:
+ * that is what the next step reads before it picks the slot after this one.
+ */
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+void BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::prefetch_child(const VariantNode<Key, RecordId, Order, InternalOrder>* slot) {
+
+    auto prefetch = [](const auto* node) {
+#if defined(__GNUC__)
+        __builtin_prefetch(&node->mutex_);
+        const char* keys = reinterpret_cast<const char*>(&node->keys_);
+        for (size_t offset = 0; offset < sizeof(node->keys_); offset += 64) {
+            __builtin_prefetch(keys + offset);
+        }
+#else
+        (void)node;
+#endif
+    };
+
+    if (slot->is_leaf()) {
+        prefetch(slot->leaf());
+    } else if (slot->is_internal()) {
+        prefetch(slot->internal());
+    }
+}
+
+
+/**
+ * @brief Looks up a group of keys optimistically with their descents interleaved
+ * 
+ * @param keys The keys to look up
+ * @param count Number of keys, at most find_many_group
+ * @param results Receives the ids found for each key
+ * @param found Set for each key whose lookup validated; the others must be retried
+ * 
+ * @details
+ * Group prefetching: every round moves each unfinished descent one level down and
+ * prefetches the node it will read next, so the cache misses of all keys on a level
+ * overlap instead of being paid one after another. A descent that sees a concurrent
+ * write drops out and is left to the caller.
+ */
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+void BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::find_group_optimistic(
+    const Key* keys, size_t count, DynamicArray<RecordId>* results, bool* found) const {
+
+    enum class State { Descending, AtLeaf, Failed };
+
+    std::array<OptimisticDescent, find_many_group> descents;
+    std::array<State, find_many_group> states;
+    std::array<const LeafNode<Key, RecordId, Order>*, find_many_group> leaves;
+    std::array<uint64_t, find_many_group> versions;
+
+    for (size_t i = 0; i < count; ++i) {
+        states[i] = start_descent_optimistic(descents[i]) ? State::Descending : State::Failed;
+    }
+
+    for (bool descending = true; descending; ) {
+        descending = false;
+        for (size_t i = 0; i < count; ++i) {
+            if (states[i] != State::Descending) {
+                continue;
+            }
+            switch (step_descent_optimistic(descents[i], keys[i], leaves[i], versions[i])) {
+                case DescentStep::Descended:
+                    prefetch_child(descents[i].slot);
+                    descending = true;
+                    break;
+                case DescentStep::Arrived:
+                    states[i] = State::AtLeaf;
+                    break;
+                case DescentStep::Restart:
+                    states[i] = State::Failed;
+                    break;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        found[i] = states[i] == State::AtLeaf &&
+                   collect_optimistic(keys[i], leaves[i], versions[i], results[i]);
+    }
+}
+
+
+/**
+ * @brief One optimistic attempt at range_search()
+ * 
+ * @return false if the attempt was invalidated; result then holds garbage
+ */
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+bool BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::range_search_optimistic(
+    const Key& from, const Key& to, DynamicArray<RecordId>& result) const {
+
+    const LeafNode<Key, RecordId, Order>* leaf;
+    uint64_t version;
+    if (!find_leaf_optimistic(from, leaf, version)) {
+        return false;
+    }
+
+    while (leaf) {
+        auto keys = leaf->keys_.begin();
+        auto values = leaf->values_.begin();
+        size_t count = std::min(leaf->keys_.size(), leaf->values_.size());
+
+        size_t index = leaf_lower_bound(*leaf, 0, count, from);
+        for (; index < count; ++index) {
+            if (comparator_(to, keys[index])) {
+                return leaf->mutex_.validate(version);
+            }
+            result.push_back(values[index]);
+        }
+
+        if (!next_leaf_optimistic(leaf, version)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+/**
+ * @brief Takes ownership of a node that has just been unlinked from the tree
+ * 
+ * @details
+ * Traversals hold raw pointers, so the node is only released once every thread that
+ * was inside an EpochGuard when it was unlinked has left its guard. Retired nodes are
+ * reclaimed in batches.
+ */
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+void BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::retire(VariantNode<Key, RecordId, Order, InternalOrder> node) {
+    if (!node) {
+        return;
+    }
+
+    if (node.is_leaf()) {
+        LeafNodeRef hint = node.leaf();
+        append_hint_.compare_exchange_strong(hint, nullptr);
+    }
+    retirements_.fetch_add(1);
+
+    uint64_t epoch = EpochDomain::global().retire_epoch();
+
+    std::lock_guard<std::mutex> lock(retired_mutex_);
+    retired_.push_back({std::move(node), epoch});
+    if (retired_.size() >= reclaim_at_) {
+        reclaim_retired();
+    }
+}
+
+
+/**
+ * @brief Frees the retired nodes that no traversal can reach any more
+ * 
+ * @note The caller holds retired_mutex_
+ */
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+void BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::reclaim_retired() {
+    uint64_t min_active = EpochDomain::global().min_active_epoch();
+
+    DynamicArray<RetiredNode> still_reachable;
+    for (auto& retired : retired_) {
+        if (retired.epoch >= min_active) {
+            still_reachable.push_back(std::move(retired));
+        }
+    }
+    retired_ = std::move(still_reachable);
+
+    // Nodes still in use are not rescanned until another batch has been retired
+    reclaim_at_ = retired_.size() + reclaim_batch;
+}
+
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+void BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::WriteLatches::release_ancestors(Path& path) {
+    for (const auto& node : nodes) {
+        node->mutex_.unlock();
+    }
+    nodes = DynamicArray<InternalNodeRef>();
+    path = Path();
+
+    if (root_lock.owns_lock()) {
+        root_lock.unlock();
+    }
+}
+
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::WriteLatches::~WriteLatches() {
+    for (const auto& node : nodes) {
+        node->mutex_.unlock();
+    }
+}
+
+
+/**
+ * @brief Tells whether a node can absorb a write without changing its parent
+ * 
+ * @details
+ * For an insert the node must have room for one more entry, so it cannot split.
+ * For a remove it must stay at or above the minimum after losing one entry, so it
+ * cannot underflow. The root has no minimum but an emptied root changes root_.
+ */
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+bool BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::is_safe(
+    WriteOp op, size_t node_size, bool is_leaf, bool is_root) const {
+
+    if (op == WriteOp::Insert) {
+        // Leaves split at Order entries, internal nodes at InternalOrder - 1 keys
+        return is_leaf ? node_size + 1 < Order : node_size + 1 < InternalOrder - 1;
+    }
+
+    if (is_root) {
+        return node_size > 1;
+    }
+    return node_size > ((is_leaf ? Order : InternalOrder) - 1) / 2;
+}
+
+
+/**
+ * @brief Descends to the leaf for a key while write-latching the nodes on the way
+ * 
+ * @param key The key being inserted or removed
+ * @param path Receives the latched part of the descent path
+ * @param latches Receives root_mutex_ and the internal node latches still held
+ * @param op The kind of write, which decides when a node is safe
+ * @param pessimistic Keep every latch down to the leaf instead of releasing at safe nodes
+ * 
+ * @return LeafNodeRef The leaf for the key with its exclusive latch held by the caller
+ * 
+ * @details
+ * Top-down latch coupling: every node is latched before its parent may be released,
+ * and as soon as a node is safe for the operation all latches above it are dropped.
+ * Writers touching different subtrees therefore only contend near the root, and
+ * only while the root itself might change.
+ */
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+typename BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::LeafNodeRef 
+BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::find_leaf_for_write(
+    const Key& key, Path& path, WriteLatches& latches, WriteOp op, bool pessimistic) {
+
+    if (root_.is_leaf()) {
+        LeafNodeRef leaf = root_.leaf();
+        leaf->mutex_.lock();
+        if (!pessimistic && is_safe(op, leaf->size(), true, true)) {
+            latches.release_ancestors(path);
+        }
+        return leaf;
+    }
+
+    InternalNodeRef current = root_.internal();
+    current->mutex_.lock();
+    bool is_root = true;
+
+    while (true) {
+        if (!pessimistic && is_safe(op, current->size(), false, is_root)) {
+            latches.release_ancestors(path);
+        }
+        latches.nodes.push_back(current);
+        is_root = false;
+
+        size_t index = child_index(*current, key);
+        path.push_back(PathEntry{current, index});
+
+        const auto& child = current->children_[index];
+
+        if (child.is_leaf()) {
+            LeafNodeRef leaf = child.leaf();
+            leaf->mutex_.lock();
+            if (!pessimistic && is_safe(op, leaf->size(), true, false)) {
+                latches.release_ancestors(path);
+            }
+            return leaf;
+        }
+
+        current = child.internal();
+        current->mutex_.lock();
+    }
+}
+
+
+/**
+ * @brief Moves a recorded descent path to the leaf that follows its current leaf
+ * 
+ * @param path Path produced by find_leaf_for_write; updated in place
+ * @param latches Latch set of the caller; internal nodes entered on the way down are added to it
+ * 
+ * @return LeafNodeRef The next leaf in key order (not latched), or nullptr if the path
+ *         ends at the last leaf
+ * 
+ * @details
+ * Climbs until an ancestor has a child to the right of the one taken, then walks
+ * down the leftmost edge of that subtree. Costs O(height). Only valid while the
+ * whole path is latched, i.e. for a pessimistic descent.
+ */
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+typename BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::LeafNodeRef 
+BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::advance_path(Path& path, WriteLatches& latches) {
+
+    // Drop the levels whose rightmost child we have already visited. On a pessimistic
+    // descent the latch set mirrors the path, so their latches go with them; keeping
+    // them would make the new subtree's left siblings unlatchable during a rebalance.
+    while (!path.empty() && path.back().index + 1 >= path.back().node->children_.size()) {
+        path.pop_back();
+        latches.nodes.back()->mutex_.unlock();
+        latches.nodes.pop_back();
+    }
+
+    if (path.empty()) {
+        return nullptr;
+    }
+
+    // Step right at the lowest level that still has a sibling subtree
+    path.back().index++;
+    NodeRef child = ref_of(path.back().node->children_[path.back().index]);
+
+    // Descend along the leftmost edge of that subtree
+    while (std::holds_alternative<InternalNodeRef>(child)) {
+        InternalNodeRef node = std::get<InternalNodeRef>(child);
+        node->mutex_.lock();
+        latches.nodes.push_back(node);
+        path.push_back(PathEntry{node, 0});
+        child = ref_of(node->children_.front());
+    }
+
+    return std::get<LeafNodeRef>(child);
+}
+
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+bool BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::is_less_or_eq(const Key& key1, const Key& key2) const {
+    return !comparator_(key2, key1);
+} 
+
+
+
+/**
+ * @brief Inserts a key-value pair into the B+ tree
+ * 
+ * @param key The key to insert
+ * @param id The record ID associated with the key
+ * 
+ * @details
+ * This method handles the insertion of new key-value pairs into the B+ tree.
+ * It handles the following cases:
+ * 1. Insertion into an empty tree
+ * 2. Insertion into an existing leaf node
+ * 3. Splitting of full nodes when necessary
+ */
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+template <typename T>
+void BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::insert(const Key& key, T&& id) {
+
+    if (mode_ == ConcurrencyMode::BLink) {
+        insert_blink(key, std::forward<T>(id), nullptr);
+    } else {
+        insert_coupled(key, std::forward<T>(id), nullptr);
+    }
+}
+
+
+/**
+ * @brief Inserts a key-value pair, starting at the leaf a hint remembers
+ * 
+ * @param key The key to insert
+ * @param id The record ID associated with the key
+ * @param hint Finger left by an earlier hinted operation; updated to the leaf the key went to
+ * 
+ * @details
+ * When the hinted leaf still covers the key and has room, the insert touches no other
+ * node. Otherwise it falls back to a full insert, which refreshes the hint. A tree with
+ * subtree counts always takes the full insert, since it has to update the whole path.
+ */
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+template <typename T>
+void BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::insert(const Key& key, T&& id, SearchHint& hint) {
+
+    if (!counted_) {
+        EpochGuard guard;
+        if (LeafNodeRef leaf = latch_search_hint(hint, key, true)) {
+            std::unique_lock<OptimisticLatch> leaf_lock(leaf->mutex_, std::adopt_lock);
+            if (is_safe(WriteOp::Insert, leaf->size(), true, false)) {
+                insert_into_leaf(leaf, key, std::forward<T>(id));
+                return;
+            }
+        }
+    }
+
+    if (mode_ == ConcurrencyMode::BLink) {
+        insert_blink(key, std::forward<T>(id), &hint);
+    } else {
+        insert_coupled(key, std::forward<T>(id), &hint);
+    }
+}
+
+
+/**
+ * @brief Inserts a key-value pair under latch coupling
+ * 
+ * @param hint Remembers the leaf the key went to, if not nullptr
+ */
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+template <typename T>
+void BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::insert_coupled(const Key& key, T&& id, SearchHint* hint) {
+
+    EpochGuard guard;
+
+    // Appends go straight to the last leaf while it has room
+    if (LeafNodeRef leaf = counted_ ? nullptr : latch_append_hint(key)) {
+        std::unique_lock<OptimisticLatch> leaf_lock(leaf->mutex_, std::adopt_lock);
+        insert_into_leaf(leaf, key, std::forward<T>(id));
+        remember_leaf(hint, leaf);
+        return;
+    }
+
+    // Fast path: shared latches down to the leaf, which alone is latched exclusively.
+    // Most inserts land in a leaf with room to spare and never touch an ancestor.
+    if (LeafNodeRef leaf = counted_ ? nullptr : descend_shared(&key, true)) {
+
+        std::unique_lock<OptimisticLatch> leaf_lock(leaf->mutex_, std::adopt_lock);
+        if (is_safe(WriteOp::Insert, leaf->size(), true, false)) {
+            insert_into_leaf(leaf, key, std::forward<T>(id));
+            set_append_hint(appends_to_last_leaf(*leaf, key) ? leaf : nullptr);
+            remember_leaf(hint, leaf);
+            return;
+        }
+    }
+
+    // Acquire exclusive lock for the root; it is released as soon as the root can no longer change
+    WriteLatches latches;
+    latches.root_lock = std::unique_lock<OptimisticLatch>(root_mutex_);
+
+    // Handle insertion into empty tree
+    if (!root_) {
+        // Create new leaf node as root
+        auto new_leaf = make_leaf();
+
+        new_leaf->keys_.push_back(key);
+        new_leaf->values_.push_back(std::forward<T>(id));  // Perfect forward the record ID
+        
+        root_ = new_leaf;
+        size_++;
+        return;
+    }
+
+    // Find the appropriate leaf node for insertion, latching the nodes a split may reach
+    // (with subtree counts, every node whose count changes)
+    Path path;
+    LeafNodeRef leaf = find_leaf_for_write(key, path, latches, WriteOp::Insert, counted_);
+    if (!leaf) {
+        throw std::runtime_error("Failed to find leaf node");
+    }
+
+    std::unique_lock<OptimisticLatch> leaf_lock(leaf->mutex_, std::adopt_lock);
+    insert_into_leaf(leaf, key, std::forward<T>(id));
+    if (counted_) {
+        count_along_path(path, 1);
+    }
+    bool append = appends_to_last_leaf(*leaf, key);
+
+    // If the leaf node is full after insertion, split it
+    LeafNodeRef target = leaf;
+    if (leaf->size() >= Order) {
+        split_leaf(leaf, path, append);
+        if (!comparator_(key, leaf->high_key_)) {
+            target = leaf->next_.get();
+        }
+    }
+    set_append_hint(append ? (leaf->next_ ? leaf->next_.get() : leaf) : nullptr);
+    remember_leaf(hint, target);
+}
+
+
+/**
+ * @brief Whether a key just inserted into a leaf went to the end of the last leaf
+ * 
+ * @note The caller holds the leaf's latch
+ */
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+bool BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::appends_to_last_leaf(
+    const LeafNode<Key, RecordId, Order>& leaf, const Key& key) const {
+    return !leaf.next_ && !comparator_(key, leaf.keys_.back());
+}
+
+
+/**
+ * @brief Remembers the last leaf while inserts keep appending to it
+ * 
+ * @param leaf The last leaf after an append, or nullptr after any other insert
+ * 
+ * @details
+ * The hint is only written when it changes, so inserts that never append keep
+ * reading a shared cache line instead of bouncing it between writers.
+ */
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+void BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::set_append_hint(LeafNodeRef leaf) {
+    if (append_hint_.load(std::memory_order_relaxed) != leaf) {
+        append_hint_.store(leaf, std::memory_order_release);
+    }
+}
+
+
+/**
+ * @brief Latches the last leaf for an append that can skip the descent
+ * 
+ * @param key The key about to be inserted
+ * 
+ * @return LeafNodeRef The hinted leaf, latched exclusively, if it is still the last leaf,
+ *         the key is not below its largest key and it has room; nullptr otherwise
+ * 
+ * @details
+ * The hint is dropped when its leaf is retired (see retire()), and the leaf's memory
+ * outlives the caller's epoch guard, so a hint read before that is still safe to
+ * latch; rereading the hint under the latch tells whether it is still current.
+ */
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+typename BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::LeafNodeRef 
+BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::latch_append_hint(const Key& key) {
+
+    LeafNodeRef leaf = append_hint_.load(std::memory_order_acquire);
+    if (!leaf) {
+        return nullptr;
+    }
+
+    leaf->mutex_.lock();
+    if (append_hint_.load(std::memory_order_relaxed) == leaf && !leaf->keys_.empty() &&
+        appends_to_last_leaf(*leaf, key) && is_safe(WriteOp::Insert, leaf->size(), true, false)) {
+        return leaf;
+    }
+    leaf->mutex_.unlock();
+    return nullptr;
+}
+
+
+/**
+ * @brief Latches the leaf a SearchHint remembers if it still covers a key
+ * 
+ * @param hint The caller's hint; re-armed for this tree if it cannot be used
+ * @param key The key about to be looked up or inserted
+ * @param exclusive Whether to latch the leaf exclusively instead of shared
+ * 
+ * @return LeafNodeRef The hinted leaf, latched, if no node has been retired since the
+ *         hint was taken and the key lies strictly between the leaf's first key and
+ *         its high key; nullptr otherwise
+ * 
+ * @details
+ * The strict bounds keep duplicates of the key out of the neighbouring leaves. The
+ * retirement count is checked before the leaf is touched: under the caller's epoch
+ * guard an unchanged count means the leaf has not been freed. It is checked again
+ * under the latch, since a merge retires a leaf while holding its latch and leaves
+ * its keys in place; an unchanged count then means the leaf is still linked into
+ * the tree. On a miss the hint
+ * takes the current count, so the leaf the caller then descends to, which cannot
+ * have been retired before, can be remembered (see remember_leaf()).
+ * 
+ * @note The caller holds an EpochGuard
+ */
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+typename BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::LeafNodeRef 
+BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::latch_search_hint(SearchHint& hint, const Key& key, bool exclusive) const {
+
+    uint64_t retirements = retirements_.load();
+    LeafNodeRef leaf = hint.leaf_;
+    if (hint.tree_ != this || hint.retirements_ != retirements || !leaf) {
+        hint.tree_ = this;
+        hint.leaf_ = nullptr;
+        hint.retirements_ = retirements;
+        return nullptr;
+    }
+
+    if (exclusive) {
+        leaf->mutex_.lock();
+    } else {
+        leaf->mutex_.lock_shared();
+    }
+    if (retirements_.load() == retirements && !leaf->keys_.empty() &&
+        comparator_(leaf->keys_.front(), key) &&
+        (!leaf->has_high_key_ || comparator_(key, leaf->high_key_))) {
+        return leaf;
+    }
+    if (exclusive) {
+        leaf->mutex_.unlock();
+    } else {
+        leaf->mutex_.unlock_shared();
+    }
+    hint.leaf_ = nullptr;
+    return nullptr;
+}
+
+
+/**
+ * @brief Points a hint at the leaf an operation ended in
+ * 
+ * @param hint The hint to update, or nullptr for an unhinted operation
+ * 
+ * @note The leaf is still linked into the tree: the caller holds its latch, or the
+ *       latch of the leaf it has just split from. The hint has been passed through
+ *       latch_search_hint() first.
+ */
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+void BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::remember_leaf(SearchHint* hint, LeafNodeRef leaf) const {
+    if (hint) {
+        hint->leaf_ = leaf;
+    }
+}
+
+
+/**
+ * @brief Places a key-value pair at its sorted position inside a latched leaf
+ */
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+template <typename T>
+void BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::insert_into_leaf(LeafNodeRef leaf, const Key& key, T&& id) {
+
+    // Find the position where the key should be inserted
+    auto it = leaf->keys_.begin() + leaf_lower_bound(*leaf, 0, leaf->keys_.size(), key);
+    size_t insert_pos = it - leaf->keys_.begin();
+
+    // Insert the key-value pair at the appropriate position
+    leaf->keys_.insert(leaf->keys_.begin() + insert_pos, key);
+    leaf->values_.insert(leaf->values_.begin() + insert_pos, std::forward<T>(id));
+    size_++;
+}
+
+
+/**
+ * @brief Splits a full leaf node into two nodes in the B+ tree
+ * 
+ * @param leaf Pointer to the leaf node that needs to be split
+ * @param path Descent path that ends at the leaf's parent; consumed while the split propagates
+ * @param append Whether the entry that filled the leaf was appended at the end of the last leaf
+ * 
+ * @details
+ * This method handles the splitting of a full leaf node
+ * The process includes:
+ * 1. Creating a new leaf node
+ * 2. Redistributing the keys and values
+ * 3. Updating the linked list of leaf nodes
+ * 4. Handling the parent node modifications
+ * 
+ * @note This method assumes the leaf node is already locked by the caller
+ */
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+void BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::split_leaf(LeafNodeRef leaf, Path& path, bool append) {
+
+    auto new_leaf = split_leaf_node(leaf, append);
+
+    // Handle the case when we're splitting the root leaf node
+    if (path.empty()) {
+        grow_root(leaf->high_key_, new_leaf);
+    
+    } else {
+        // The parent and the leaf's slot in it come straight from the descent path
+        auto parent = path.back().node;
+        size_t insert_pos = path.back().index;
+        path.pop_back();
+
+        // Insert the new key and child pointer into the parent
+        parent->keys_.insert(parent->keys_.begin() + insert_pos, leaf->high_key_);
+        parent->children_.insert(parent->children_.begin() + insert_pos + 1, 
+                               new_leaf);
+        if (counted_) {
+            parent->counts_.insert(parent->counts_.begin() + insert_pos + 1, 0);
+            refresh_counts(parent, insert_pos, insert_pos + 2);
+        }
+
+        // If the parent becomes full after insertion, split it
+        if (parent->is_full()) {
+            split_internal(parent, path, append && insert_pos + 1 == parent->keys_.size());
+        }
+    }
+}
+
+
+/**
+ * @brief Moves the upper half of a full leaf into a new right sibling
+ * 
+ * @param leaf The leaf to split, latched exclusively by the caller
+ * @param append Whether the entry that filled the leaf was appended at the end of the last leaf
+ * 
+ * @return LeafNodePtr The new leaf; the old leaf's new high key is the separator for the parent
+ * 
+ * @details
+ * The new leaf takes over the old high key and right link, and the old leaf is bounded
+ * by the separator, so a search that reaches the old leaf can still move right. The
+ * separator is the shortest key between the two halves (see separator_between()).
+ * 
+ * An append split moves only the appended entry: with ascending keys nothing will be
+ * inserted into the old leaf again, so it stays full instead of half empty.
+ */
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+typename BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::LeafNodePtr
+BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::split_leaf_node(LeafNodeRef leaf, bool append) {
+
+    // Create a new leaf node to hold half of the elements
+    auto new_leaf = make_leaf();
+    
+    size_t mid = append ? leaf->keys_.size() - 1 : leaf_split_point(*leaf);
+    
+    // Copy the second half of keys and values to the new leaf
+    new_leaf->keys_.assign(leaf->keys_.begin() + mid, leaf->keys_.end());
+    new_leaf->values_.assign(leaf->values_.begin() + mid, leaf->values_.end());
+    
+    // Resize the original leaf to keep only the first half
+    leaf->keys_.resize(mid);
+    leaf->values_.resize(mid);
+
+    new_leaf->high_key_ = leaf->high_key_;
+    new_leaf->has_high_key_ = leaf->has_high_key_;
+    leaf->high_key_ = separator_between(leaf->keys_.back(), new_leaf->keys_.front());
+    leaf->has_high_key_ = true;
+    
+    // Update the linked list pointers
+    // new_leaf->next_ points to whatever leaf->next_ was pointing to
+    new_leaf->next_ = leaf->next_;
+    new_leaf->prev_.store(leaf, std::memory_order_relaxed);
+    if (new_leaf->next_) {
+        new_leaf->next_->prev_.store(new_leaf.get(), std::memory_order_release);
+    }
+    // leaf->next_ now points to the new leaf
+    leaf->next_ = new_leaf;
+
+    return new_leaf;
+}
+
+
+/**
+ * @brief Splits a full internal node into two nodes in the B+ tree
+ * 
+ * @param node Pointer to the internal node that needs to be split
+ * @param path Descent path that ends at the node's parent
+ * @param append Whether the separator that filled the node is its last key and came
+ *        from an append split below
+ * 
+ * @details
+ * This method handles the splitting of a full internal node.
+ * The process includes:
+ * 1. Creating a new internal node
+ * 2. Moving half of the keys and children to the new node
+ * 3. Promoting the middle key to the parent
+ * 4. Handling special case when splitting the root
+ */
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+void BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::split_internal(InternalNodeRef node, Path& path, bool append) {
+
+    Key mid_key;  // This key will be promoted to the parent
+    auto new_node = split_internal_node(node, mid_key, append && !node->right_);
+
+    // Handle the case when splitting the root internal node
+    if (path.empty()) {
+        grow_root(mid_key, new_node);
+    
+    } else {
+        // Handle the case when splitting a non-root internal node
+        auto parent = path.back().node;
+        size_t insert_pos = path.back().index;
+        path.pop_back();
+
+        // Insert the promoted key and new node pointer into the parent
+        parent->keys_.insert(parent->keys_.begin() + insert_pos, mid_key);
+        parent->children_.insert(parent->children_.begin() + insert_pos + 1, 
+                               new_node);
+        if (counted_) {
+            parent->counts_.insert(parent->counts_.begin() + insert_pos + 1, 0);
+            refresh_counts(parent, insert_pos, insert_pos + 2);
+        }
+
+        // If the parent becomes full after insertion, split it recursively
+        if (parent->is_full()) {
+            split_internal(parent, path, append && insert_pos + 1 == parent->keys_.size());
+        }
+    }
+}
+
+
+/**
+ * @brief Moves the upper half of a full internal node into a new right sibling
+ * 
+ * @param node The node to split, latched exclusively by the caller
+ * @param separator Receives the middle key, which moves up to the parent
+ * @param append Whether the node is the last on its level and is growing at its end
+ * 
+ * @return InternalNodePtr The new node
+ * 
+ * @details
+ * An append split leaves about 90% of the keys behind. The new node always receives
+ * at least one key, so that it can route a search by itself.
+ */
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+typename BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::InternalNodePtr
+BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::split_internal_node(InternalNodeRef node, Key& separator, bool append) {
+
+    // Create a new internal node to hold right half of elements
+    auto new_node = make_internal();
+    new_node->level_ = node->level_;
+    
+    // Find the middle point and the key that will be promoted
+    size_t size = node->keys_.size();
+    size_t mid = append ? std::max(size / 2, std::min(size - 2, size - 1 - size / 10)) : internal_split_point(*node);
+    separator = node->keys_[mid];
+    
+    // Move keys and children after the middle to the new node
+    // !!!: For internal nodes, middle key goes up, not copied
+    new_node->keys_.assign(node->keys_.begin() + mid + 1, node->keys_.end());
+    new_node->children_.assign(node->children_.begin() + mid + 1, node->children_.end());
+    if (counted_) {
+        new_node->counts_.assign(node->counts_.begin() + mid + 1, node->counts_.end());
+        node->counts_.resize(mid + 1);
+    }
+    
+    // Resize the original node to remove transferred elements
+    node->keys_.resize(mid);  // Remove middle key and everything after
+    node->children_.resize(mid + 1);  // Keep one more child than keys
+
+    new_node->high_key_ = node->high_key_;
+    new_node->has_high_key_ = node->has_high_key_;
+    new_node->right_ = node->right_;
+    node->high_key_ = separator;
+    node->has_high_key_ = true;
+    node->right_ = new_node;
+
+    return new_node;
+}
+
+
+/**
+ * @brief Puts a new root above the current root, which has just split, and its new sibling
+ * 
+ * @note The caller holds root_mutex_ exclusively
+ */
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+void BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::grow_root(
+    const Key& separator, const VariantNode<Key, RecordId, Order, InternalOrder>& right) {
+
+    auto new_root = make_internal();
+    if (root_.is_internal()) {
+        new_root->level_ = root_.internal()->level_ + 1;
+    }
+
+    // Add the separator and set up the children pointers
+    new_root->keys_.push_back(separator);
+    new_root->children_.push_back(root_);
+    new_root->children_.push_back(right);
+    if (counted_) {
+        new_root->counts_.push_back(subtree_count(root_));
+        new_root->counts_.push_back(subtree_count(right));
+    }
+
+    // Update the root
+    root_ = new_root;
+}
+
+
+// ---------------- B-LINK WRITES ----------------
+
+
+/**
+ * @brief Inserts a key-value pair following the B-link protocol
+ * 
+ * @details
+ * The descent holds one latch at a time and ends with the covering leaf latched
+ * exclusively. A split leaves the old node latched until its parent has received the
+ * separator (see insert_into_parent_blink()), so the new sibling cannot split before
+ * the parent knows about it.
+ * 
+ * @param hint Remembers the leaf the key went to, if not nullptr
+ */
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+template <typename T>
+void BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::insert_blink(const Key& key, T&& id, SearchHint* hint) {
+
+    EpochGuard guard;
+
+    if (LeafNodeRef leaf = latch_append_hint(key)) {
+        insert_into_leaf(leaf, key, std::forward<T>(id));
+        remember_leaf(hint, leaf);
+        leaf->mutex_.unlock();
+        return;
+    }
+
+    Path path;
+    LeafNodeRef leaf;
+    while (!(leaf = descend_blink(&key, true, &path))) {
+        // Handle insertion into empty tree
+        std::unique_lock root_lock(root_mutex_);
+        if (!root_) {
+            auto new_leaf = make_leaf();
+            new_leaf->keys_.push_back(key);
+            new_leaf->values_.push_back(std::forward<T>(id));
+            root_ = new_leaf;
+            size_++;
+            return;
+        }
+    }
+
+    insert_into_leaf(leaf, key, std::forward<T>(id));
+    bool append = appends_to_last_leaf(*leaf, key);
+
+    if (leaf->size() < Order) {
+        set_append_hint(append ? leaf : nullptr);
+        remember_leaf(hint, leaf);
+        leaf->mutex_.unlock();
+        return;
+    }
+
+    auto new_leaf = split_leaf_node(leaf, append);
+    set_append_hint(append ? new_leaf.get() : nullptr);
+    remember_leaf(hint, comparator_(key, leaf->high_key_) ? leaf : new_leaf.get());
+    insert_into_parent_blink(leaf, leaf->high_key_, new_leaf, path, append);
+}
+
+
+/**
+ * @brief Links a new right sibling into the parent of a node that has just split
+ * 
+ * @param child The node that split, latched exclusively; the latch is released here
+ * @param separator Separator between child and sibling
+ * @param sibling The new right sibling of child
+ * @param path Internal nodes visited by the descent, one per level
+ * @param append Whether the child split because of an append at the end of the tree
+ * 
+ * @details
+ * The parent recorded on the way down may have split since, in which case the child
+ * now hangs off one of its right siblings; the parent latch moves right until the
+ * child is found. Latches are only ever taken bottom-up and left to right, so this
+ * cannot deadlock against other B-link operations. A full parent is split in turn
+ * and the loop continues one level up. If the child was the root when the descent
+ * started but the tree has grown since, its parent is looked up from the new root.
+ */
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+void BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::insert_into_parent_blink(
+    NodeRef child, Key separator,
+    VariantNode<Key, RecordId, Order, InternalOrder> sibling, Path& path, bool append) {
+
+    while (true) {
+        InternalNodeRef parent;
+
+        if (path.empty()) {
+            std::unique_lock root_lock(root_mutex_);
+            if (ref_of(root_) == child) {
+                grow_root(separator, sibling);
+                unlock_node(child);
+                return;
+            }
+            root_lock.unlock();
+            parent = find_parent_blink(child, separator);
+        } else {
+            parent = path.back().node;
+            path.pop_back();
+        }
+
+        parent->mutex_.lock();
+        size_t index = 0;
+        while (true) {
+            while (index < parent->children_.size() && ref_of(parent->children_[index]) != child) {
+                ++index;
+            }
+            if (index < parent->children_.size()) {
+                break;
+            }
+
+            // The parent split after the descent passed it
+            InternalNodeRef right = parent->right_.get();
+            right->mutex_.lock();
+            parent->mutex_.unlock();
+            parent = right;
+            index = 0;
+        }
+
+        // The sibling is reachable from the parent now, so the child can be let go
+        unlock_node(child);
+
+        parent->keys_.insert(parent->keys_.begin() + index, separator);
+        parent->children_.insert(parent->children_.begin() + index + 1, sibling);
+
+        if (!parent->is_full()) {
+            parent->mutex_.unlock();
+            return;
+        }
+
+        append = append && index + 1 == parent->keys_.size() && !parent->right_;
+
+        Key promoted;
+        sibling = split_internal_node(parent, promoted, append);
+        separator = promoted;
+        child = parent;
+    }
+}
+
+
+/**
+ * @brief Finds the node one level above a child by descending from the current root
+ * 
+ * @param child The node whose parent is needed
+ * @param key A key within the child's range
+ * 
+ * @return InternalNodeRef A node on the parent level at or to the left of the parent,
+ *         unlatched; the caller moves right from it
+ */
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+typename BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::InternalNodeRef
+BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::find_parent_blink(
+    const NodeRef& child, const Key& key) const {
+
+    size_t level = std::holds_alternative<InternalNodeRef>(child)
+                 ? std::get<InternalNodeRef>(child)->level_ + 1 : 0;
+
+    NodeRef node;
+    {
+        std::shared_lock root_lock(root_mutex_);
+        node = ref_of(root_);
+    }
+
+    while (true) {
+        InternalNodeRef current = std::get<InternalNodeRef>(node);
+        std::shared_lock<OptimisticLatch> node_lock(current->mutex_);
+
+        while (moves_right(*current, key)) {
+            InternalNodeRef right = current->right_.get();
+            std::shared_lock<OptimisticLatch> right_lock(right->mutex_);
+            node_lock.swap(right_lock);
+            current = right;
+        }
+
+        if (current->level_ == level) {
+            return current;
+        }
+        node = ref_of(current->children_[child_index(*current, key)]);
+    }
+}
+
+
+/**
+ * @brief Removes the first entry with a given key following the B-link protocol
+ * 
+ * @details
+ * Only the leaf holding the entry is latched. Nodes are never merged, so leaves may
+ * become underfull or empty; the tree keeps its shape until the entries come back.
+ */
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+void BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::remove_blink(const Key& key) {
+
+    EpochGuard guard;
+
+    LeafNodeRef leaf = descend_blink(&key, true, nullptr);
+    if (!leaf) {
+        return;
+    }
+    std::unique_lock<OptimisticLatch> leaf_lock(leaf->mutex_, std::adopt_lock);
+
+    auto it = leaf->keys_.begin() + leaf_lower_bound(*leaf, 0, leaf->keys_.size(), key);
+
+    // A run of duplicates equal to the high key may start in a leaf further right
+    while (it == leaf->keys_.end()) {
+        if (!leaf->next_ || !leaf->has_high_key_ || comparator_(key, leaf->high_key_)) {
+            return;
+        }
+
+        LeafNodeRef next = leaf->next_.get();
+        std::unique_lock<OptimisticLatch> next_lock(next->mutex_);
+        leaf_lock.swap(next_lock);
+        leaf = next;
+        it = leaf->keys_.begin() + leaf_lower_bound(*leaf, 0, leaf->keys_.size(), key);
+    }
+
+    if (comparator_(key, *it)) {
+        return;
+    }
+
+    size_t remove_pos = it - leaf->keys_.begin();
+    leaf->keys_.erase(leaf->keys_.begin() + remove_pos);
+    leaf->values_.erase(leaf->values_.begin() + remove_pos);
+    --size_;
+}
+
+
+/**
+ * @brief Removes a key and its associated value from the B+ tree
+ * 
+ * @param key The key to remove
+ * 
+ * @details
+ * This method handles the removal of a key-value pair, including:
+ * 1. Finding the appropriate leaf node
+ * 2. Removing the key-value pair
+ * 3. Handling underflow situations through rebalancing
+ * 4. Special handling for root node
+ */
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+void BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::remove(const Key& key) {
+
+    if (mode_ == ConcurrencyMode::BLink) {
+        remove_blink(key);
+        return;
+    }
+
+    EpochGuard guard;
+
+    // Subtree counts change all the way up, so the whole path is latched from the start
+    if (counted_) {
+        remove_impl(key, Descent::Pessimistic);
+        return;
+    }
+
+    // Each attempt latches more of the tree than the previous one and only gives up
+    // when the removal would restructure nodes it has not latched
+    for (Descent mode : {Descent::Optimistic, Descent::Coupled, Descent::Pessimistic}) {
+        if (remove_impl(key, mode)) {
+            return;
+        }
+    }
+}
+
+
+/**
+ * @brief Performs one removal attempt
+ * 
+ * @param key The key to remove
+ * @param mode Optimistic latches only the leaf exclusively, Coupled releases ancestors
+ *        at safe nodes, Pessimistic keeps the whole descent path latched
+ * 
+ * @return false if the attempt had to back off and should be retried with a stronger mode
+ */
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+bool BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::remove_impl(const Key& key, Descent mode) {
+
+    WriteLatches latches;
+    Path path;
+    LeafNodeRef leaf = nullptr;
+
+    if (mode == Descent::Optimistic) {
+        leaf = descend_shared(&key, true);
+    } else {
+        latches.root_lock = std::unique_lock<OptimisticLatch>(root_mutex_);
+        if (root_) {
+            // Find the leaf node containing the key, latching the nodes a merge may reach
+            leaf = find_leaf_for_write(key, path, latches, WriteOp::Remove, mode == Descent::Pessimistic);
+        }
+    }
+
+    // Return if tree is empty
+    if (!leaf) {
+        return true;
+    }
+
+    // Lock the leaf node for exclusive access
+    std::unique_lock<OptimisticLatch> leaf_lock(leaf->mutex_, std::adopt_lock);
+
+    // An optimistic pass holds no ancestor, so it may only touch a leaf that stays above minimum
+    if (mode == Descent::Optimistic && !is_safe(WriteOp::Remove, leaf->size(), true, false)) {
+        return false;
+    }
+
+    // Find the position of the key in the leaf
+    auto it = leaf->keys_.begin() + leaf_lower_bound(*leaf, 0, leaf->keys_.size(), key);
+
+    // Every key of this leaf is smaller, so the first match can only open the next leaf
+    if (it == leaf->keys_.end()) {
+        if (mode != Descent::Pessimistic) {
+            LeafNodeRef next = leaf->next_.get();
+            if (!next) {
+                return true;
+            }
+
+            std::unique_lock<OptimisticLatch> next_lock(next->mutex_);
+            if (next->keys_.empty() || comparator_(key, next->keys_.front())) {
+                return true;
+            }
+
+            // Without its parent latched the neighbour may only lose a key if it stays above minimum
+            if (!is_safe(WriteOp::Remove, next->size(), true, false)) {
+                return false;
+            }
+
+            next->keys_.erase(next->keys_.begin());
+            next->values_.erase(next->values_.begin());
+            --size_;
+            return true;
+        }
+
+        leaf_lock.unlock();
+        leaf = advance_path(path, latches);
+        if (!leaf) {
+            return true;
+        }
+        leaf_lock = std::unique_lock<OptimisticLatch>(leaf->mutex_);
+        it = leaf->keys_.begin();
+    }
+    
+    // Return if key doesn't exist
+    if (it == leaf->keys_.end() || comparator_(key, *it) || comparator_(*it, key)) {
+        return true; 
+    }
+
+    // Calculate position and remove key-value pair
+    size_t remove_pos = it - leaf->keys_.begin();
+    leaf->keys_.erase(leaf->keys_.begin() + remove_pos);
+    leaf->values_.erase(leaf->values_.begin() + remove_pos);
+    --size_;
+    if (counted_) {
+        count_along_path(path, -1);
+    }
+
+    // Handle case where root becomes empty (an optimistic pass never empties a leaf,
+    // so root_ is only inspected here while root_mutex_ is held)
+    if (leaf->keys_.empty() && root_.is_leaf()) {
+        retire(std::exchange(root_, nullptr));
+        return true;
+    }
+
+    // Check if the leaf needs rebalancing
+    const size_t min_size = (Order - 1) / 2;
+    if (leaf->keys_.size() < min_size) {
+        balance_after_remove(NodeRef(leaf), path);
+    }
+    return true;
+}
+
+
+/**
+ * @brief Balances a node (leaf or internal) after removal
+ * 
+ * @param node The variant node that needs balancing
+ * @param path Descent path that ends at the node's parent
+ * 
+ * @details
+ * Borrows one entry from an adjacent sibling when that sibling can spare it and
+ * merges with a sibling otherwise. A merge can leave the parent underfull, in which
+ * case the parent is balanced in turn one level up the path; a root left with a
+ * single child is replaced by that child.
+ * 
+ * @note The node and every node on the path are write-latched by the caller;
+ * siblings are latched here for the duration of the borrow or merge.
+ */
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+void BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::balance_after_remove(
+    NodeRef node, Path& path) {
+
+    // Skip if node is empty
+    if (std::holds_alternative<std::monostate>(node)) {
+        return;
+    }
+
+    // The root has no siblings; it only shrinks when an internal root runs out of keys
+    if (path.empty()) {
+        if (std::holds_alternative<InternalNodeRef>(node)) {
+            InternalNodeRef root = std::get<InternalNodeRef>(node);
+            if (root->keys_.empty()) {
+                retire(std::exchange(root_, root->children_.front()));
+            }
+        }
+        return;
+    }
+
+    auto parent = path.back().node;
+    size_t node_idx = path.back().index;
+    path.pop_back();
+
+    const size_t min_size = ((std::holds_alternative<LeafNodeRef>(node) ? Order : InternalOrder) - 1) / 2;
+    const size_t parent_min_size = (InternalOrder - 1) / 2;
+    auto node_size = [](const NodeRef& n) -> size_t {
+        return std::holds_alternative<LeafNodeRef>(n) ? std::get<LeafNodeRef>(n)->size()
+                                                      : std::get<InternalNodeRef>(n)->size();
+    };
+
+    NodeRef left = std::monostate{};
+    NodeRef right = std::monostate{};
+    if (node_idx > 0) {
+        left = ref_of(parent->children_[node_idx - 1]);
+    }
+    if (node_idx + 1 < parent->children_.size()) {
+        right = ref_of(parent->children_[node_idx + 1]);
+    }
+
+    // Latch the siblings. Leaves are latched left to right, as scans do, so the node's
+    // own latch is given up while its left neighbour is taken. The parent stays latched,
+    // so the node cannot be split, merged or removed from meanwhile, but the append and
+    // SearchHint fast paths latch a leaf directly and may insert into it.
+    if (std::holds_alternative<LeafNodeRef>(left)) {
+        unlock_node(node);
+        lock_node(left);
+        lock_node(node);
+    } else {
+        lock_node(left);
+    }
+    lock_node(right);
+
+    // Such an insert may have refilled the node; a merge is then no longer needed, and
+    // could overflow the left sibling
+    if (node_size(node) >= min_size) {
+        unlock_node(left);
+        unlock_node(right);
+        return;
+    }
+
+    // Try to redistribute with left sibling, then with right sibling
+    if (node_idx > 0 && node_size(left) > min_size) {
+        redistribute_nodes(parent, node_idx - 1);
+    } else if (!std::holds_alternative<std::monostate>(right) && node_size(right) > min_size) {
+        redistribute_nodes(parent, node_idx);
+    } else if (node_idx > 0) {
+        // If redistribution isn't possible, merge with a sibling
+        merge_nodes(parent, node_idx - 1);
+    } else if (!std::holds_alternative<std::monostate>(right)) {
+        merge_nodes(parent, node_idx);
+    }
+
+    unlock_node(left);
+    unlock_node(right);
+
+    // Recursively balance the parent if needed; an empty path means the parent was
+    // either the root or safe, and a safe parent cannot have dropped below minimum
+    if (path.empty() ? parent->keys_.empty() : parent->keys_.size() < parent_min_size) {
+        balance_after_remove(parent, path);
+    }
+}
+
+/**
+ * @brief Redistributes keys between two adjacent nodes
+ * 
+ * @param parent Parent of both nodes
+ * @param left_index Index of the left node in the parent; the right node follows it
+ * 
+ * @details
+ * Moves one entry from the larger node to the smaller one and refreshes the
+ * separator between them. Internal nodes rotate through the parent separator.
+ */
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+void BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::redistribute_nodes(
+    InternalNodeRef parent, size_t left_index) {
+
+    auto& lhs = parent->children_[left_index];
+    auto& rhs = parent->children_[left_index + 1];
+    
+    // Handle redistribution between leaf nodes
+    if (lhs.is_leaf()) {
+        LeafNodeRef left = lhs.leaf();
+        LeafNodeRef right = rhs.leaf();
+
+        if (left->size() > right->size()) {
+            // Move last key-value pair from left to right
+            right->keys_.insert(right->keys_.begin(), left->keys_.back());
+            right->values_.insert(right->values_.begin(), left->values_.back());
+
+            left->keys_.pop_back();
+            left->values_.pop_back();
+        } else {
+            // Move first key-value pair from right to left
+            left->keys_.push_back(right->keys_.front());
+            left->values_.push_back(right->values_.front());
+
+            right->keys_.erase(right->keys_.begin());
+            right->values_.erase(right->values_.begin());
+        }
+
+        // Update parent's key
+        parent->keys_[left_index] = separator_between(left->keys_.back(), right->keys_.front());
+        left->high_key_ = parent->keys_[left_index];
+        if (counted_) {
+            refresh_counts(parent, left_index, left_index + 2);
+        }
+        return;
+    }
+
+    // Handle redistribution between internal nodes
+    InternalNodeRef left = lhs.internal();
+    InternalNodeRef right = rhs.internal();
+
+    if (left->size() > right->size()) {
+        // Rotate right: the separator comes down, the left node's last key goes up
+        right->keys_.insert(right->keys_.begin(), parent->keys_[left_index]);
+        right->children_.insert(right->children_.begin(), left->children_.back());
+        parent->keys_[left_index] = left->keys_.back();
+        if (counted_) {
+            right->counts_.insert(right->counts_.begin(), left->counts_.back());
+            left->counts_.pop_back();
+        }
+
+        left->keys_.pop_back();
+        left->children_.pop_back();
+    } else {
+        // Rotate left: the separator comes down, the right node's first key goes up
+        left->keys_.push_back(parent->keys_[left_index]);
+        left->children_.push_back(right->children_.front());
+        parent->keys_[left_index] = right->keys_.front();
+        if (counted_) {
+            left->counts_.push_back(right->counts_.front());
+            right->counts_.erase(right->counts_.begin());
+        }
+
+        right->keys_.erase(right->keys_.begin());
+        right->children_.erase(right->children_.begin());
+    }
+
+    left->high_key_ = parent->keys_[left_index];
+    if (counted_) {
+        refresh_counts(parent, left_index, left_index + 2);
+    }
+}
+
+
+/**
+ * @brief Merges two adjacent nodes in the B+ tree
+ * 
+ * @param parent Parent of both nodes
+ * @param left_index Index of the left node in the parent; the right node follows it
+ * 
+ * @details
+ * Merges two nodes by moving all contents from the right node to the left node
+ * and updating the parent node accordingly. Internal nodes also pull down the
+ * separator that divided them.
+ */
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+void BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::merge_nodes(
+    InternalNodeRef parent, size_t left_index) {
+
+    auto& left = parent->children_[left_index];
+    auto& right = parent->children_[left_index + 1];
+    
+    // Handle merging of leaf nodes
+    if (left.is_leaf()) {
+        LeafNodeRef left_leaf = left.leaf();
+        LeafNodeRef right_leaf = right.leaf();
+
+        // Move all keys from right leaf to left leaf
+        left_leaf->keys_.insert(left_leaf->keys_.end(), 
+                              right_leaf->keys_.begin(), 
+                              right_leaf->keys_.end());
+        // Move all values from right leaf to left leaf
+        left_leaf->values_.insert(left_leaf->values_.end(), 
+                                right_leaf->values_.begin(), 
+                                right_leaf->values_.end());
+
+        // Update the next pointer to maintain leaf node chain
+        left_leaf->next_ = right_leaf->next_;
+        if (left_leaf->next_) {
+            left_leaf->next_->prev_.store(left_leaf, std::memory_order_release);
+        }
+        left_leaf->high_key_ = right_leaf->high_key_;
+        left_leaf->has_high_key_ = right_leaf->has_high_key_;
+    } else {
+        InternalNodeRef left_node = left.internal();
+        InternalNodeRef right_node = right.internal();
+
+        // The separator becomes the key between the two child sequences
+        left_node->keys_.push_back(parent->keys_[left_index]);
+        left_node->keys_.insert(left_node->keys_.end(),
+                              right_node->keys_.begin(),
+                              right_node->keys_.end());
+        left_node->children_.insert(left_node->children_.end(),
+                                  right_node->children_.begin(),
+                                  right_node->children_.end());
+        if (counted_) {
+            left_node->counts_.insert(left_node->counts_.end(),
+                                    right_node->counts_.begin(),
+                                    right_node->counts_.end());
+        }
+
+        left_node->right_ = right_node->right_;
+        left_node->high_key_ = right_node->high_key_;
+        left_node->has_high_key_ = right_node->has_high_key_;
+    }
+
+    // Update parent node by removing the right child and its corresponding key
+    retire(right);
+    parent->children_.erase(parent->children_.begin() + left_index + 1);
+    parent->keys_.erase(parent->keys_.begin() + left_index);
+    if (counted_) {
+        parent->counts_.erase(parent->counts_.begin() + left_index + 1);
+        refresh_counts(parent, left_index, left_index + 1);
+    }
+}
+
+// ---------------- SUBTREE COUNTS ----------------
+
+
+/**
+ * @brief Number of entries under a node, from its own counts for an internal node
+ */
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+size_t BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::subtree_count(const VariantNode<Key, RecordId, Order, InternalOrder>& node) {
+    if (node.is_leaf()) {
+        return node.leaf()->size();
+    }
+    if (node.is_internal()) {
+        const auto& counts = node.internal()->counts_;
+        return std::accumulate(counts.begin(), counts.end(), size_t{0});
+    }
+    return 0;
+}
+
+
+/**
+ * @brief Recomputes the counts of the children [first, last) of a node after they were
+ *        split, merged or rebalanced
+ * 
+ * @note The caller holds the node and those children latched exclusively
+ */
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+void BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::refresh_counts(InternalNodeRef parent, size_t first, size_t last) {
+    for (size_t i = first; i < last; ++i) {
+        parent->counts_[i] = subtree_count(parent->children_[i]);
+    }
+}
+
+
+/**
+ * @brief Adds delta to the count of every child slot a descent went through
+ * 
+ * @note The whole path is latched exclusively (a pessimistic descent)
+ */
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+void BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::count_along_path(const Path& path, ptrdiff_t delta) {
+    for (const auto& entry : path) {
+        entry.node->counts_[entry.index] += static_cast<size_t>(delta);  // wraps for negative deltas
+    }
+}
+
+
+/**
+ * @brief Number of entries whose key is less than key, or not greater than it if inclusive
+ * 
+ * @details
+ * One descent that adds up the counts of the children left of the path and finishes
+ * with a binary search in the leaf. An inclusive descent follows the last child
+ * whose keys can equal the key instead of the first, so duplicates are counted
+ * without walking along them.
+ * 
+ * @note The caller holds root_mutex_ shared. With subtree counts every writer holds
+ *       root_mutex_ exclusively for its whole operation, so no node can change.
+ */
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+size_t BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::count_before(const Key& key, bool inclusive) const {
+
+    NodeRef node = ref_of(root_);
+    size_t before = 0;
+
+    while (std::holds_alternative<InternalNodeRef>(node)) {
+        InternalNodeRef internal = std::get<InternalNodeRef>(node);
+        size_t index = inclusive
+            ? std::upper_bound(internal->keys_.begin(), internal->keys_.end(), key, comparator_) - internal->keys_.begin()
+            : child_index(*internal, key);
+        before = std::accumulate(internal->counts_.begin(), internal->counts_.begin() + index, before);
+        node = ref_of(internal->children_[index]);
+    }
+
+    if (std::holds_alternative<LeafNodeRef>(node)) {
+        LeafNodeRef leaf = std::get<LeafNodeRef>(node);
+        auto it = inclusive ? std::upper_bound(leaf->keys_.begin(), leaf->keys_.end(), key, comparator_)
+                            : leaf->keys_.begin() + leaf_lower_bound(*leaf, 0, leaf->keys_.size(), key);
+        before += it - leaf->keys_.begin();
+    }
+    return before;
+}
+
+
+/**
+ * @brief Counts the entries with keys in [from, to] without visiting them
+ * 
+ * @return The number of records range_search(from, to) would return
+ * 
+ * @throws std::logic_error if the tree was not created with SubtreeCounts::On
+ * 
+ * @details
+ * Two descents, to the end of the range and to its start, each O(log n) regardless of
+ * how many entries lie in between. Both run under one shared root latch, so the count
+ * is consistent with a single point in time.
+ */
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+size_t BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::count(const Key& from, const Key& to) {
+
+    if (!counted_) {
+        throw std::logic_error("count requires SubtreeCounts::On");
+    }
+    if (comparator_(to, from)) {
+        return 0;
+    }
+
+    std::shared_lock<OptimisticLatch> root_lock(root_mutex_);
+    return count_before(to, true) - count_before(from, false);
+}
+
+
+/**
+ * @brief Number of entries whose key is less than key
+ * 
+ * @throws std::logic_error if the tree was not created with SubtreeCounts::On
+ */
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+size_t BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::rank(const Key& key) {
+
+    if (!counted_) {
+        throw std::logic_error("rank requires SubtreeCounts::On");
+    }
+
+    std::shared_lock<OptimisticLatch> root_lock(root_mutex_);
+    return count_before(key, false);
+}
+
+
+/**
+ * @brief Returns an iterator to the entry at position k in key order
+ * 
+ * @param k Zero-based position; select(rank(key)) is lower_bound(key)
+ * 
+ * @return Iterator to the entry, or end() if the tree holds k entries or fewer
+ * 
+ * @throws std::logic_error if the tree was not created with SubtreeCounts::On
+ * 
+ * @details
+ * Descends by subtracting the counts of the children it skips. The iterator is not
+ * latched; it is invalidated like any Iterator.
+ */
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+typename BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::Iterator 
+BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::select(size_t k) {
+
+    if (!counted_) {
+        throw std::logic_error("select requires SubtreeCounts::On");
+    }
+
+    EpochGuard guard;
+    std::shared_lock<OptimisticLatch> root_lock(root_mutex_);
+
+    NodeRef node = ref_of(root_);
+    while (std::holds_alternative<InternalNodeRef>(node)) {
+        InternalNodeRef internal = std::get<InternalNodeRef>(node);
+        size_t index = 0;
+        while (index < internal->counts_.size() && k >= internal->counts_[index]) {
+            k -= internal->counts_[index];
+            ++index;
+        }
+        if (index == internal->counts_.size()) {
+            return end();
+        }
+        node = ref_of(internal->children_[index]);
+    }
+
+    if (!std::holds_alternative<LeafNodeRef>(node) || k >= std::get<LeafNodeRef>(node)->size()) {
+        return end();
+    }
+    return Iterator(std::get<LeafNodeRef>(node), k, this);
+}
+
+
+
+// ---------------- BULK LOADING ----------------
+
+
+/**
+ * @brief Replaces the contents of the tree with a sorted sequence of entries
+ * 
+ * @param first, last Range of (key, record id) pairs, sorted by key; duplicates are allowed
+ * @param fill_factor Share of each node's capacity to fill, in (0, 1]. Values below the
+ *        minimum occupancy of a node are raised to it.
+ * 
+ * @throws std::invalid_argument if the fill factor is out of range or the input is not
+ *         sorted; the tree is left unchanged
+ * 
+ * @details
+ * Leaves are filled left to right and linked as they are created, then each internal
+ * level is built over the one below it, so the whole tree is written once and no node
+ * is ever split. Entries are spread evenly over the nodes of a level, which keeps the
+ * last node of a level from being left nearly empty. A fill factor below 1 leaves room
+ * for later inserts before nodes have to split.
+ * 
+ * The new tree is built off to the side and swapped in under the root latch; the old
+ * nodes are retired like those of clear().
+ */
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+template <typename ForwardIt>
+void BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::bulk_load(
+    ForwardIt first, ForwardIt last, double fill_factor) {
+
+    if (!(fill_factor > 0.0 && fill_factor <= 1.0)) {
+        throw std::invalid_argument("bulk_load fill factor must be in (0, 1]");
+    }
+
+    // A leaf splits when it reaches Order entries and an internal node when it
+    // reaches InternalOrder - 1 keys, so they hold at most Order - 1 entries and
+    // InternalOrder - 1 children respectively
+    const size_t leaf_capacity = Order - 1;
+    const size_t internal_capacity = InternalOrder - 1;
+    const size_t count = static_cast<size_t>(std::distance(first, last));
+
+    // Leaf level, with the lower bound and the entry count of every node kept for the level above
+    DynamicArray<VariantNode<Key, RecordId, Order, InternalOrder>> level;
+    DynamicArray<Key> low_keys;
+    DynamicArray<size_t> counts;
+
+    size_t leaf_count = packed_node_count(count, leaf_capacity, fill_factor);
+    LeafNodePtr previous = nullptr;
+
+    for (size_t l = 0; l < leaf_count; ++l) {
+        size_t entries = count / leaf_count + (l < count % leaf_count ? 1 : 0);
+        auto leaf = make_leaf();
+
+        for (size_t e = 0; e < entries; ++e, ++first) {
+            const auto& [key, id] = *first;
+
+            const Key* before = !leaf->keys_.empty() ? &leaf->keys_.back()
+                              : previous ? &previous->keys_.back() : nullptr;
+            if (before && comparator_(key, *before)) {
+                throw std::invalid_argument("bulk_load input is not sorted");
+            }
+
+            leaf->keys_.push_back(key);
+            leaf->values_.push_back(id);
+        }
+
+        if (previous) {
+            previous->next_ = leaf;
+            leaf->prev_.store(previous.get(), std::memory_order_relaxed);
+            previous->high_key_ = separator_between(previous->keys_.back(), leaf->keys_.front());
+            previous->has_high_key_ = true;
+        }
+
+        low_keys.push_back(previous ? previous->high_key_ : leaf->keys_.front());
+        counts.push_back(entries);
+        level.push_back(leaf);
+        previous = leaf;
+    }
+
+    // Internal levels, until a single node is left to become the root
+    for (size_t height = 0; level.size() > 1; ++height) {
+        DynamicArray<VariantNode<Key, RecordId, Order, InternalOrder>> upper;
+        DynamicArray<Key> upper_low_keys;
+        DynamicArray<size_t> upper_counts;
+
+        size_t node_count = packed_node_count(level.size(), internal_capacity, fill_factor);
+        InternalNodePtr left = nullptr;
+        size_t child = 0;
+
+        for (size_t n = 0; n < node_count; ++n) {
+            size_t children = level.size() / node_count + (n < level.size() % node_count ? 1 : 0);
+            auto node = make_internal();
+            node->level_ = height;
+
+            // Separator i is the low key of child i + 1, which bounds it from below
+            size_t entries = 0;
+            for (size_t c = 0; c < children; ++c, ++child) {
+                if (c > 0) {
+                    node->keys_.push_back(low_keys[child]);
+                }
+                node->children_.push_back(level[child]);
+                if (counted_) {
+                    node->counts_.push_back(counts[child]);
+                }
+                entries += counts[child];
+            }
+
+            const Key& low_key = low_keys[child - children];
+            if (left) {
+                left->right_ = node;
+                left->high_key_ = low_key;
+                left->has_high_key_ = true;
+            }
+
+            upper_low_keys.push_back(low_key);
+            upper_counts.push_back(entries);
+            upper.push_back(node);
+            left = node;
+        }
+
+        level = std::move(upper);
+        low_keys = std::move(upper_low_keys);
+        counts = std::move(upper_counts);
+    }
+
+    VariantNode<Key, RecordId, Order, InternalOrder> new_root = nullptr;
+    if (!level.empty()) {
+        new_root = level[0];
+    }
+
+    std::unique_lock write_lock(root_mutex_);
+    append_hint_.store(nullptr);
+    retire(std::exchange(root_, std::move(new_root)));
+    size_ = count;
+}
+
+
+/**
+ * @brief Number of nodes a bulk-loaded level needs for a given number of items
+ * 
+ * @param items Entries (for leaves) or child nodes (for internal nodes) on the level
+ * @param capacity Maximum items per node
+ * @param fill_factor Target share of the capacity, clamped to at least half of it
+ * 
+ * @details
+ * Spreading the items evenly over the returned number of nodes keeps every node at or
+ * below capacity and, once there is more than one node, at or above half of it.
+ */
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+size_t BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::packed_node_count(
+    size_t items, size_t capacity, double fill_factor) {
+
+    if (items == 0) {
+        return 0;
+    }
+
+    size_t target = static_cast<size_t>(fill_factor * capacity + 0.5);
+    target = std::clamp(target, (capacity + 1) / 2, capacity);
+
+    size_t at_target = items / target;
+    size_t at_capacity = (items + capacity - 1) / capacity;
+    return std::max({at_target, at_capacity, size_t{1}});
+}
+
+
+// ---------------- BATCH INSERTS ----------------
+
+
+/**
+ * @brief Inserts many key-value pairs, visiting each target leaf once
+ * 
+ * @param batch The entries to insert, in any order; duplicates are allowed
+ * 
+ * @details
+ * The batch is sorted and consumed in runs: one descent latches the leaf for the
+ * smallest remaining key, and every following key up to the leaf's high key is merged
+ * into it in a single pass. A run that overflows the leaf is spread over as many new
+ * leaves as it needs, which are linked into the parent together (see
+ * insert_batch_run()). A B-link tree takes runs that fill the leaf up to one split.
+ * 
+ * Readers and other writers may run concurrently; each run is atomic on its own.
+ */
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+void BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::insert_batch(
+    std::span<const std::pair<Key, RecordId>> batch) {
+
+    BatchEntries sorted(batch.begin(), batch.end());
+    std::stable_sort(sorted.begin(), sorted.end(), [this](const auto& a, const auto& b) {
+        return comparator_(a.first, b.first);
+    });
+
+    EpochGuard guard;
+
+    size_t next = 0;
+    while (next < sorted.size()) {
+        next = mode_ == ConcurrencyMode::BLink ? insert_batch_run_blink(sorted, next)
+                                               : insert_batch_run(sorted, next);
+    }
+}
+
+
+/**
+ * @brief Finds how far a run of sorted batch entries belongs to a leaf
+ * 
+ * @return One past the last entry that is within the leaf's high key, taking at most
+ *         limit entries from first
+ */
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+size_t BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::batch_run_end(
+    const LeafNode<Key, RecordId, Order>& leaf, const BatchEntries& batch,
+    size_t first, size_t limit) const {
+
+    size_t last = first;
+    while (last < batch.size() && last - first < limit &&
+           (!leaf.has_high_key_ || !comparator_(leaf.high_key_, batch[last].first))) {
+        ++last;
+    }
+    return last;
+}
+
+
+/**
+ * @brief Merges sorted batch entries [first, last) into a latched leaf that has room for them
+ * 
+ * @details
+ * Merges from the back, so every entry moves at most once. A new entry goes before
+ * existing entries with an equal key, as a single insert would put it. Keys with a
+ * prefix array change only through it, so they are merged into a buffer and assigned.
+ */
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+void BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::merge_into_leaf(
+    LeafNodeRef leaf, const BatchEntries& batch, size_t first, size_t last) {
+
+    if constexpr (KeyPrefix<Key>::enabled) {
+        DynamicArray<Key> keys;
+        DynamicArray<RecordId> values;
+        size_t from_leaf = 0;
+        for (size_t from_batch = first; from_batch < last || from_leaf < leaf->size();) {
+            if (from_batch == last ||
+                (from_leaf < leaf->size() && comparator_(leaf->keys_[from_leaf], batch[from_batch].first))) {
+                keys.push_back(leaf->keys_[from_leaf]);
+                values.push_back(std::move(leaf->values_[from_leaf]));
+                ++from_leaf;
+            } else {
+                keys.push_back(batch[from_batch].first);
+                values.push_back(batch[from_batch].second);
+                ++from_batch;
+            }
+        }
+        leaf->keys_.assign(keys.begin(), keys.end());
+        leaf->values_.assign(values.begin(), values.end());
+
     } else {
-        merge_nodes(node, parent->children_[node_idx + 1]);
+        size_t existing = leaf->keys_.size();
+        size_t total = existing + (last - first);
+        leaf->keys_.resize(total);
+        leaf->values_.resize(total);
+
+        size_t from_leaf = existing;
+        size_t from_batch = last;
+        for (size_t slot = total; slot-- > 0 && from_batch > first;) {
+            if (from_leaf > 0 && !comparator_(leaf->keys_[from_leaf - 1], batch[from_batch - 1].first)) {
+                --from_leaf;
+                leaf->keys_[slot] = std::move(leaf->keys_[from_leaf]);
+                leaf->values_[slot] = std::move(leaf->values_[from_leaf]);
+            } else {
+                --from_batch;
+                leaf->keys_[slot] = batch[from_batch].first;
+                leaf->values_[slot] = batch[from_batch].second;
+            }
+        }
+    }
+
+    size_ += last - first;
+}
+
+
+/**
+ * @brief Inserts the run of batch entries that starts at first under latch coupling
+ * 
+ * @return Index of the first entry that was not inserted
+ * 
+ * @details
+ * A run that fits in its leaf only latches the leaf. Otherwise the descent keeps the
+ * whole path latched, and the leaf's entries and the run are written out over several
+ * evenly filled leaves. The run is capped so that all the new separators fit in the
+ * parent, which then splits at most once, like after a single leaf split; a root leaf
+ * that overflows gets a new root above all its parts.
+ */
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+size_t BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::insert_batch_run(const BatchEntries& batch, size_t first) {
+
+    const size_t leaf_capacity = Order - 1;
+
+    // Fast path: the run fits in the leaf, which alone is latched
+    if (LeafNodeRef leaf = counted_ ? nullptr : descend_shared(&batch[first].first, true)) {
+        std::unique_lock<OptimisticLatch> leaf_lock(leaf->mutex_, std::adopt_lock);
+        size_t last = batch_run_end(*leaf, batch, first, leaf_capacity - std::min(leaf_capacity, leaf->size()));
+        if (last > first) {
+            merge_into_leaf(leaf, batch, first, last);
+            return last;
+        }
+    }
+
+    WriteLatches latches;
+    latches.root_lock = std::unique_lock<OptimisticLatch>(root_mutex_);
+    if (!root_) {
+        root_ = make_leaf();
+    }
+
+    Path path;
+    LeafNodeRef leaf = find_leaf_for_write(batch[first].first, path, latches, WriteOp::Insert, true);
+    std::unique_lock<OptimisticLatch> leaf_lock(leaf->mutex_, std::adopt_lock);
+
+    // The parent may take separators until it is full; a root leaf gets a fresh parent
+    size_t parent_room = path.empty() ? InternalOrder - 2 : (InternalOrder - 1) - path.back().node->keys_.size();
+    size_t limit = (parent_room + 1) * leaf_capacity - leaf->size();
+    size_t last = batch_run_end(*leaf, batch, first, limit);
+
+    if (counted_) {
+        count_along_path(path, static_cast<ptrdiff_t>(last - first));
+    }
+
+    if (leaf->size() + (last - first) <= leaf_capacity) {
+        merge_into_leaf(leaf, batch, first, last);
+        return last;
+    }
+
+    // Merge the leaf and the run into a buffer, new entries first among equal keys
+    DynamicArray<Key> keys;
+    DynamicArray<RecordId> values;
+    size_t from_leaf = 0;
+    for (size_t from_batch = first; from_batch < last || from_leaf < leaf->size();) {
+        if (from_batch == last ||
+            (from_leaf < leaf->size() && comparator_(leaf->keys_[from_leaf], batch[from_batch].first))) {
+            keys.push_back(std::move(leaf->keys_[from_leaf]));
+            values.push_back(std::move(leaf->values_[from_leaf]));
+            ++from_leaf;
+        } else {
+            keys.push_back(batch[from_batch].first);
+            values.push_back(batch[from_batch].second);
+            ++from_batch;
+        }
+    }
+    size_ += last - first;
+
+    // Spread the merged entries evenly over the leaf and its new right siblings
+    size_t total = keys.size();
+    size_t parts = (total + leaf_capacity - 1) / leaf_capacity;
+
+    DynamicArray<LeafNodePtr> siblings;
+    DynamicArray<Key> separators;  // separators[i] bounds siblings[i] from below
+    LeafNodeRef left = leaf;
+    size_t offset = 0;
+
+    for (size_t p = 0; p < parts; ++p) {
+        size_t entries = total / parts + (p < total % parts ? 1 : 0);
+
+        LeafNodeRef part = left;
+        LeafNodePtr sibling = nullptr;
+        if (p > 0) {
+            sibling = make_leaf();
+            part = sibling.get();
+        }
+
+        part->keys_.assign(keys.begin() + offset, keys.begin() + offset + entries);
+        part->values_.assign(values.begin() + offset, values.begin() + offset + entries);
+        offset += entries;
+
+        if (sibling) {
+            // Link the new leaf before it becomes reachable from its left neighbour
+            sibling->next_ = left->next_;
+            sibling->prev_.store(left, std::memory_order_relaxed);
+            if (sibling->next_) {
+                sibling->next_->prev_.store(sibling.get(), std::memory_order_release);
+            }
+            sibling->high_key_ = left->high_key_;
+            sibling->has_high_key_ = left->has_high_key_;
+            left->high_key_ = separator_between(left->keys_.back(), sibling->keys_.front());
+            left->has_high_key_ = true;
+            left->next_ = sibling;
+
+            separators.push_back(left->high_key_);
+            siblings.push_back(sibling);
+            left = sibling.get();
+        }
+    }
+
+    if (path.empty()) {
+        auto new_root = make_internal();
+        new_root->children_.push_back(root_);
+        for (size_t i = 0; i < siblings.size(); ++i) {
+            new_root->keys_.push_back(separators[i]);
+            new_root->children_.push_back(siblings[i]);
+        }
+        if (counted_) {
+            new_root->counts_.resize(new_root->children_.size());
+            refresh_counts(new_root.get(), 0, new_root->children_.size());
+        }
+        root_ = new_root;
+        return last;
+    }
+
+    InternalNodeRef parent = path.back().node;
+    size_t index = path.back().index;
+    path.pop_back();
+
+    for (size_t i = 0; i < siblings.size(); ++i) {
+        parent->keys_.insert(parent->keys_.begin() + index + i, separators[i]);
+        parent->children_.insert(parent->children_.begin() + index + 1 + i, siblings[i]);
+        if (counted_) {
+            parent->counts_.insert(parent->counts_.begin() + index + 1 + i, 0);
+        }
+    }
+    if (counted_) {
+        refresh_counts(parent, index, index + 1 + siblings.size());
+    }
+
+    if (parent->is_full()) {
+        split_internal(parent, path);
+    }
+    return last;
+}
+
+
+/**
+ * @brief Inserts the run of batch entries that starts at first following the B-link protocol
+ * 
+ * @return Index of the first entry that was not inserted
+ * 
+ * @details
+ * The run fills the leaf up to Order entries; a full leaf is split once and linked
+ * into its parent bottom-up, as insert_blink() does.
+ */
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+size_t BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::insert_batch_run_blink(const BatchEntries& batch, size_t first) {
+
+    Path path;
+    LeafNodeRef leaf;
+    while (!(leaf = descend_blink(&batch[first].first, true, &path))) {
+        std::unique_lock root_lock(root_mutex_);
+        if (!root_) {
+            root_ = make_leaf();
+        }
+    }
+
+    size_t last = batch_run_end(*leaf, batch, first, Order - std::min(Order - 1, leaf->size()));
+    merge_into_leaf(leaf, batch, first, last);
+
+    if (leaf->size() < Order) {
+        leaf->mutex_.unlock();
+        return last;
+    }
+
+    auto new_leaf = split_leaf_node(leaf);
+    insert_into_parent_blink(leaf, leaf->high_key_, new_leaf, path);
+    return last;
+}
+
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+bool BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::empty() const {
+    // A B-link tree keeps its emptied leaves, so the root alone does not tell
+    return size_.load() == 0;
+}
+
+/**
+ * @brief Finds and returns the record ID associated with a given key
+ * 
+ * @param key The key to search for
+ * 
+ * @details
+ * Returns an empty vector if the key is not found.
+ */
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+DynamicArray<RecordId> BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::find(const Key& key) {
+
+    EpochGuard guard;
+    DynamicArray<RecordId> result;
+
+    if constexpr (optimistic_reads) {
+        for (size_t attempt = 0; attempt < optimistic_read_attempts; ++attempt) {
+            if (find_optimistic(key, result)) {
+                return result;
+            }
+            result = DynamicArray<RecordId>();
+        }
+    }
+
+    // Find the leaf node containing the key; it comes back shared-latched
+    LeafNodeRef leaf = find_leaf(key);
+    if (!leaf) {
+        return result;
+    }
+    std::shared_lock<OptimisticLatch> leaf_lock(leaf->mutex_, std::adopt_lock);
+    collect_latched(key, leaf, leaf_lock, result);
+    return result;
+}
+
+
+/**
+ * @brief Finds the record IDs of a key, starting at the leaf a hint remembers
+ * 
+ * @param key The key to search for
+ * @param hint Finger left by an earlier hinted operation; updated to the leaf the key lies in
+ * 
+ * @details
+ * Lookups of nearby keys in a row skip the descent while they stay inside one leaf.
+ * A miss costs one latched descent, which is slower than the optimistic one find()
+ * takes, so this pays off only when most lookups hit the hinted leaf.
+ */
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+DynamicArray<RecordId> BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::find(const Key& key, SearchHint& hint) {
+
+    EpochGuard guard;
+    DynamicArray<RecordId> result;
+
+    LeafNodeRef leaf = latch_search_hint(hint, key, false);
+    if (!leaf && !(leaf = find_leaf(key))) {
+        return result;
+    }
+    std::shared_lock<OptimisticLatch> leaf_lock(leaf->mutex_, std::adopt_lock);
+    remember_leaf(&hint, leaf);
+    collect_latched(key, leaf, leaf_lock, result);
+    return result;
+}
+
+
+/**
+ * @brief Appends the record IDs of a key to result, starting at a shared-latched leaf
+ * 
+ * @param leaf The leftmost leaf that may hold the key
+ * @param leaf_lock Holds the latch of leaf; it moves along as a run of duplicates
+ *        continues into the next leaves
+ */
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+void BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::collect_latched(
+    const Key& key, LeafNodeRef leaf, std::shared_lock<OptimisticLatch>& leaf_lock,
+    DynamicArray<RecordId>& result) const {
+
+    while (leaf) {
+        // Search for the key in the leaf node
+        auto it = leaf->keys_.begin() + leaf_lower_bound(*leaf, 0, leaf->keys_.size(), key);
+
+        while (it != leaf->keys_.end()) {
+            if (comparator_(key, *it)) {
+                return;
+            }
+            size_t index = it - leaf->keys_.begin();
+            result.push_back(leaf->values_[index]); 
+            ++it;
+        }
+
+        leaf = next_leaf_shared(leaf, leaf_lock);
+    }
+}
+
+
+
+/**
+ * @brief Looks up many keys at once
+ * 
+ * @param keys The keys to look up
+ * 
+ * @return For each key, in the same order, the record ids find() would return
+ * 
+ * @details
+ * Keys are processed in groups of find_many_group whose optimistic descents are
+ * interleaved level by level with the next node of each prefetched (see
+ * find_group_optimistic()). On trees larger than the cache this hides most of the
+ * per-level miss latency a loop over find() pays in full. One epoch guard covers
+ * the whole batch. Keys whose optimistic lookup is invalidated by a concurrent write,
+ * and all keys when optimistic reads are unavailable, go through find().
+ */
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+DynamicArray<DynamicArray<RecordId>> BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::find_many(
+    std::span<const Key> keys) {
+
+    EpochGuard guard;
+    DynamicArray<DynamicArray<RecordId>> results;
+
+    for (size_t first = 0; first < keys.size(); first += find_many_group) {
+        size_t count = std::min(find_many_group, keys.size() - first);
+        std::array<DynamicArray<RecordId>, find_many_group> group;
+        std::array<bool, find_many_group> found{};
+
+        if constexpr (optimistic_reads) {
+            find_group_optimistic(keys.data() + first, count, group.data(), found.data());
+        }
+
+        for (size_t i = 0; i < count; ++i) {
+            results.push_back(found[i] ? std::move(group[i]) : find(keys[first + i]));
+        }
+    }
+
+    return results;
+}
+
+
+
+/**
+ * @brief Performs a range search in the B+ tree
+ * 
+ * @param from The lower bound of the range 
+ * @param to The upper bound of the range 
+ * 
+ * @details
+ * Performs a range search by traversing leaf nodes from the lower bound
+ * until reaching the upper bound or the end of the tree.
+ */
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+DynamicArray<RecordId> BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::range_search(
+    const Key& from, const Key& to) {
+
+    EpochGuard guard;
+    DynamicArray<RecordId> result;
+
+    if constexpr (optimistic_reads) {
+        for (size_t attempt = 0; attempt < optimistic_read_attempts; ++attempt) {
+            if (range_search_optimistic(from, to, result)) {
+                return result;
+            }
+            result = DynamicArray<RecordId>();
+        }
     }
 
-    // Recursively balance the parent if needed
-    if (parent->keys_.size() < (Order - 1) / 2) {
-        balance_after_remove(parent);
+    scan(from, to, [&result](const Key&, const RecordId& id) {
+        result.push_back(id);
+    });
+
+    return result;
+}
+
+
+
+/**
+ * @brief Returns at most the first limit entries of a range search
+ * 
+ * @param from The lower bound of the range
+ * @param to The upper bound of the range
+ * @param limit Maximum number of record ids to return
+ * 
+ * @details
+ * The scan stops at the limit, so the cost depends on the page size rather than on
+ * the size of the range.
+ */
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+DynamicArray<RecordId> BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::range_search(
+    const Key& from, const Key& to, size_t limit) {
+
+    RangeCursor cursor;
+    return range_search(from, to, limit, cursor);
+}
+
+
+
+/**
+ * @brief Returns the next page of a range search and advances the cursor
+ * 
+ * @param from The lower bound of the range
+ * @param to The upper bound of the range
+ * @param limit Maximum number of record ids to return
+ * @param cursor Where the previous page ended; updated to where this one ends
+ * 
+ * @details
+ * Keyset pagination: a page resumes with one descent to the cursor's last key and
+ * skips the duplicates of that key the previous pages already returned, instead of
+ * rescanning from the lower bound. Once a page reaches the upper bound the cursor is
+ * marked exhausted and later calls return nothing.
+ * 
+ * @note Pages are not a snapshot. Entries inserted behind the cursor are not seen, and
+ *       removing duplicates of the cursor's key can shift the next page by that many.
+ */
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+DynamicArray<RecordId> BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::range_search(
+    const Key& from, const Key& to, size_t limit, RangeCursor& cursor) {
+
+    DynamicArray<RecordId> result;
+    if (cursor.exhausted || limit == 0) {
+        return result;
     }
+
+    auto same_key = [this](const Key& a, const Key& b) {
+        return !comparator_(a, b) && !comparator_(b, a);
+    };
+
+    // Entries equal to the last key come first when resuming from it
+    size_t skip = cursor.last_key ? cursor.duplicates : 0;
+    const Key start = cursor.last_key ? *cursor.last_key : from;
+
+    scan(start, to, [&](const Key& key, const RecordId& id) {
+        if (skip > 0 && same_key(key, *cursor.last_key)) {
+            --skip;
+            return true;
+        }
+        skip = 0;
+
+        if (cursor.last_key && same_key(key, *cursor.last_key)) {
+            ++cursor.duplicates;
+        } else {
+            cursor.last_key = key;
+            cursor.duplicates = 1;
+        }
+
+        result.push_back(id);
+        return result.size() < limit;
+    });
+
+    cursor.exhausted = result.size() < limit;
+    return result;
 }
 
+
+
 /**
- * @brief Redistributes keys between two adjacent nodes
+ * @brief Copies the entries a reverse scan starts with
  * 
- * @param lhs Left node in the redistribution
- * @param rhs Right node in the redistribution
+ * @param bound Largest key of interest
+ * @param entries Receives, in key order, the entries with keys up to the bound from the
+ *        leftmost leaf that may hold the bound and from the leaves after it that hold
+ *        duplicates of it
+ * @param prev Receives the left neighbour of the leftmost of those leaves
+ * @param version Receives that leaf's version at the time it was read
  * 
- * @details
- * Handles the redistribution of keys between adjacent nodes
+ * @return LeafNodeRef The leftmost leaf read (unlatched), or nullptr for an empty tree
  */
 
-template <typename Key, typename RecordId, size_t Order, typename compare>
-void BPlusTree<Key, RecordId, Order, compare>::redistribute_nodes(
-    VariantNode<Key, RecordId, Order>& lhs, 
-    VariantNode<Key, RecordId, Order>& rhs) {
-    
-    // Handle redistribution between leaf nodes
-    if (std::holds_alternative<LeafNodePtr>(lhs) && std::holds_alternative<LeafNodePtr>(rhs)) {
-        auto left = std::get<LeafNodePtr>(lhs);
-        auto right = std::get<LeafNodePtr>(rhs);
-
-        // Move last key-value pair from left to right
-        right->keys_.insert(right->keys_.begin(), left->keys_.back());
-        right->values_.insert(right->values_.begin(), left->values_.back());
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+typename BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::LeafNodeRef 
+BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::reverse_scan_start(
+    const Key& bound, BatchEntries& entries, LeafNodeRef& prev, uint64_t& version) const {
 
-        left->keys_.pop_back();
-        left->values_.pop_back();
+    prev = nullptr;
+    LeafNodeRef first = find_leaf(bound);
+    if (!first) {
+        return nullptr;
+    }
+    std::shared_lock<OptimisticLatch> leaf_lock(first->mutex_, std::adopt_lock);
+    prev = first->prev_.load(std::memory_order_acquire);
+    first->mutex_.read_version(version);
 
-        // Update parent's key
-        auto parent = find_parent(lhs);
-        if (parent) {
-            size_t idx = std::find(parent->children_.begin(), 
-                                 parent->children_.end(), 
-                                 rhs) - parent->children_.begin();
-            if (idx > 0) {
-                parent->keys_[idx - 1] = right->keys_.front();
+    // Duplicates of the bound can continue in the leaves to the right
+    for (LeafNodeRef leaf = first; leaf; leaf = next_leaf_shared(leaf, leaf_lock)) {
+        for (size_t i = 0; i < leaf->keys_.size(); ++i) {
+            if (comparator_(bound, leaf->keys_[i])) {
+                return first;
             }
+            entries.emplace_back(leaf->keys_[i], leaf->values_[i]);
         }
     }
+    return first;
 }
 
 
+
 /**
- * @brief Merges two adjacent nodes in the B+ tree
+ * @brief Returns the entries with keys in [from, to] in descending key order
+ * 
+ * @param to The upper bound of the range, where the scan starts
+ * @param from The lower bound of the range
+ * @param limit Maximum number of record ids to return
+ * 
+ * @return Record ids from the largest key down
  * 
  * @details
- * Merges two nodes by moving all contents from the right node to the left node
- * and updating the parent node accordingly. 
+ * One descent to the upper bound, then the scan walks left through prev_ links, so the
+ * last N entries of a range cost O(log n + N). Leaves are only ever latched left to
+ * right, so a backward step latches the left neighbour after letting go of the
+ * current leaf and checks that the two are still adjacent and that the leaf it left
+ * has not changed since. If either check fails the scan descends again to the
+ * smallest key returned so far and skips the duplicates of it it has already
+ * returned, the same way a RangeCursor resumes a forward scan.
  */
 
-template <typename Key, typename RecordId, size_t Order, typename compare>
-void BPlusTree<Key, RecordId, Order, compare>::merge_nodes(
-    VariantNode<Key, RecordId, Order>& left, 
-    VariantNode<Key, RecordId, Order>& right) {
-    
-    // Handle merging of leaf nodes
-    if (std::holds_alternative<LeafNodePtr>(left) && std::holds_alternative<LeafNodePtr>(right)) {
-        auto left_leaf = std::get<LeafNodePtr>(left);
-        auto right_leaf = std::get<LeafNodePtr>(right);
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+DynamicArray<RecordId> BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::reverse_range_search(
+    const Key& to, const Key& from, size_t limit) {
 
-        // Move all keys from right leaf to left leaf
-        left_leaf->keys_.insert(left_leaf->keys_.end(), 
-                              right_leaf->keys_.begin(), 
-                              right_leaf->keys_.end());
-        // Move all values from right leaf to left leaf
-        left_leaf->values_.insert(left_leaf->values_.end(), 
-                                right_leaf->values_.begin(), 
-                                right_leaf->values_.end());
+    EpochGuard guard;
+    DynamicArray<RecordId> result;
+    if (limit == 0 || comparator_(to, from)) {
+        return result;
+    }
 
-        // Update the next pointer to maintain leaf node chain
-        left_leaf->next_ = right_leaf->next_;
+    auto same_key = [this](const Key& a, const Key& b) {
+        return !comparator_(a, b) && !comparator_(b, a);
+    };
+
+    // Everything above the bound, and at_bound entries equal to it, have been returned
+    Key bound = to;
+    size_t at_bound = 0;
+    size_t skip = 0;
 
-        // Update parent node by removing the right child and its corresponding key
-        auto parent = find_parent(left);
-        if (parent) {
-            size_t idx = std::find(parent->children_.begin(), parent->children_.end(), right) - parent->children_.begin();
+    BatchEntries entries;
+    LeafNodeRef prev = nullptr;
+    uint64_t version = 0;
+    LeafNodeRef leaf = reverse_scan_start(bound, entries, prev, version);
 
-            parent->children_.erase(parent->children_.begin() + idx);
-            parent->keys_.erase(parent->keys_.begin() + idx - 1);
+    while (true) {
+        for (auto it = entries.rbegin(); it != entries.rend(); ++it) {
+            const auto& [key, id] = *it;
+            if (comparator_(key, from)) {
+                return result;
+            }
+
+            if (same_key(key, bound)) {
+                if (skip > 0) {
+                    --skip;
+                    continue;
+                }
+                ++at_bound;
+            } else {
+                bound = key;
+                at_bound = 1;
+            }
+
+            result.push_back(id);
+            if (result.size() == limit) {
+                return result;
+            }
         }
-    }
-}
 
-template <typename Key, typename RecordId, size_t Order, typename compare>
-bool BPlusTree<Key, RecordId, Order, compare>::empty() const {
-    // Tree is empty if root is monostate
-    if (std::holds_alternative<std::monostate>(root_)) {
-        return true;    
+        if (!prev) {
+            return result;
+        }
+        entries.clear();
+
+        prev->mutex_.lock_shared();
+        if (prev->next_.get() == leaf && leaf->mutex_.validate(version)) {
+            for (size_t i = 0; i < prev->keys_.size(); ++i) {
+                entries.emplace_back(prev->keys_[i], prev->values_[i]);
+            }
+            LeafNodeRef before = prev->prev_.load(std::memory_order_acquire);
+            prev->mutex_.read_version(version);
+            prev->mutex_.unlock_shared();
+
+            leaf = prev;
+            prev = before;
+        } else {
+            prev->mutex_.unlock_shared();
+            leaf = reverse_scan_start(bound, entries, prev, version);
+            skip = at_bound;
+        }
     }
-    return false;
 }
 
+
+
 /**
- * @brief Finds and returns the record ID associated with a given key
+ * @brief Streams the entries with keys in [from, to] to a visitor, in key order
  * 
- * @param key The key to search for
+ * @param from The lower bound of the range
+ * @param to The upper bound of the range
+ * @param visitor Called as visitor(key, id) for every entry in the range. If it returns
+ *        bool, returning false stops the scan.
+ * 
+ * @return Number of entries passed to the visitor
  * 
  * @details
- * Returns an empty vector if the key is not found.
+ * Nothing is materialized: the scan walks the leaves holding a shared latch on the
+ * current one, so memory use does not depend on the size of the range and the first
+ * entry is delivered as soon as its leaf is reached.
+ * 
+ * @note The visitor runs while a leaf latch is held; it must not modify the tree.
  */
 
-template <typename Key, typename RecordId, size_t Order, typename compare>
-DynamicArray<RecordId> BPlusTree<Key, RecordId, Order, compare>::find(const Key& key) {
-
-    // Acquire shared lock for reading
-    std::shared_lock read_lock(root_mutex_);
-
-    // Return empty vector if tree is empty
-    if (std::holds_alternative<std::monostate>(root_)) {
-        return DynamicArray<RecordId>(); 
-    }
-
-    // Find the leaf node containing the key
-    LeafNodePtr leaf = find_leaf(key);
-    if (!leaf) {
-        return DynamicArray<RecordId>();
-    }
-
-    // Acquire shared lock for leaf node
-    std::shared_lock leaf_lock(leaf->mutex_);
-
-    // Search for the key in the leaf node
-    auto it = std::lower_bound(leaf->keys_.begin(), leaf->keys_.end(), key, comparator_);
-    DynamicArray<RecordId> result;
-
-    // Collect all matching records
-    while (it != leaf->keys_.end() && !comparator_(key, *it) && !comparator_(*it, key)) {
-        size_t index = it - leaf->keys_.begin();
-        result.push_back(leaf->values_[index]); 
-        ++it;
-    }
-
-    return result;
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+template <typename Visitor>
+size_t BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::scan(const Key& from, const Key& to, Visitor&& visitor) {
 
-    // Return empty vector if key not found
-    return DynamicArray<RecordId>();
+    return scan_while(from, [this, &to](const Key& key) { return !comparator_(to, key); },
+                      std::forward<Visitor>(visitor));
 }
 
 
-
 /**
- * @brief Performs a range search in the B+ tree
+ * @brief Streams the entries from the first key not less than from to a visitor, in
+ *        key order, for as long as in_range(key) holds
  * 
- * @param from The lower bound of the range 
- * @param to The upper bound of the range 
+ * @return Number of entries passed to the visitor
  * 
  * @details
- * Performs a range search by traversing leaf nodes from the lower bound
- * until reaching the upper bound or the end of the tree.
+ * The scan behind scan() and prefix_search(). in_range must hold for a prefix of the
+ * keys from from on, so the scan ends at the first key outside the range.
  */
 
-template <typename Key, typename RecordId, size_t Order, typename compare>
-DynamicArray<RecordId> BPlusTree<Key, RecordId, Order, compare>::range_search(
-    const Key& from, const Key& to) {
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+template <typename InRange, typename Visitor>
+size_t BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::scan_while(
+    const Key& from, InRange&& in_range, Visitor&& visitor) {
 
-    // Acquire shared lock for reading
-    std::shared_lock read_lock(root_mutex_);
-    DynamicArray<RecordId> result;
+    EpochGuard guard;
+    size_t visited = 0;
 
-    // Return empty result if tree is empty
-    if (std::holds_alternative<std::monostate>(root_)) {
-        return result;
+    LeafNodeRef leaf = find_leaf(from);
+    if (!leaf) {
+        return visited;
     }
+    std::shared_lock<OptimisticLatch> leaf_lock(leaf->mutex_, std::adopt_lock);
 
-    // Find the leaf node containing the lower bound
-    LeafNodePtr current = find_leaf(from);
-    if (!current) {
-        return result;
-    }
+    while (leaf) {
+        auto it = leaf->keys_.begin() + leaf_lower_bound(*leaf, 0, leaf->keys_.size(), from);
 
-    // Traverse through leaf nodes
-    while (current) {
-        // Lock current leaf for reading
-        std::shared_lock leaf_lock(current->mutex_);
+        for (size_t index = it - leaf->keys_.begin(); index < leaf->keys_.size(); ++index) {
+            if (!in_range(leaf->keys_[index])) {
+                return visited;
+            }
+            ++visited;
 
-        // Find the first key greater than or equal to 'from'
-        auto start_it = std::lower_bound(current->keys_.begin(), current->keys_.end(), from, comparator_);
-        
-        // Collect all keys in range [from, to)
-        for (auto it = start_it; it != current->keys_.end(); ++it) {
-            
-            // Stop if we've reached the upper bound
-            if (comparator_(to, *it)) {
-                return result;
+            if constexpr (std::is_same_v<std::invoke_result_t<Visitor&, const Key&, const RecordId&>, bool>) {
+                if (!visitor(leaf->keys_[index], leaf->values_[index])) {
+                    return visited;
+                }
+            } else {
+                visitor(leaf->keys_[index], leaf->values_[index]);
             }
-            
-            // Add matching record ID to results
-            size_t index = it - current->keys_.begin();
-            result.push_back(current->values_[index]);
         }
 
-        // Move to next leaf node
-        current = current->next_;
+        leaf = next_leaf_shared(leaf, leaf_lock);
     }
 
-    return result;
+    return visited;
 }
 
 
@@ -714,28 +3396,21 @@ DynamicArray<RecordId> BPlusTree<Key, RecordId, Order, compare>::range_search(
  * Traverses all leaf nodes and applies the predicate to each key.
  */
 
-template <typename Key, typename RecordId, size_t Order, typename compare>
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
 template<typename Predicate>
-DynamicArray<RecordId> BPlusTree<Key, RecordId, Order, compare>::find_if(Predicate pred) {
-    // Acquire shared lock for reading
-    std::shared_lock read_lock(root_mutex_);
+DynamicArray<RecordId> BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::find_if(Predicate pred) {
+    EpochGuard guard;
     DynamicArray<RecordId> result;
-    
-    // Return empty result if tree is empty
-    if (std::holds_alternative<std::monostate>(root_)) {
-        return result;
-    }
 
     // Find the leftmost leaf node
-    LeafNodePtr leaf = std::holds_alternative<LeafNodePtr>(root_) ?
-                      std::get<LeafNodePtr>(root_) :  // Root is leaf
-                      find_leaf(std::get<InternalNodePtr>(root_)->keys_.front());  // Find leftmost leaf
+    LeafNodeRef leaf = leftmost_leaf();
+    if (!leaf) {
+        return result;
+    }
+    std::shared_lock<OptimisticLatch> leaf_lock(leaf->mutex_, std::adopt_lock);
                       
     // Traverse all leaf nodes
     while (leaf) {
-        // Lock current leaf for reading
-        std::shared_lock leaf_lock(leaf->mutex_);
-        
         // Check each key against the predicate
         for (size_t i = 0; i < leaf->size(); ++i) {
             if (pred(leaf->keys_[i])) {
@@ -744,7 +3419,7 @@ DynamicArray<RecordId> BPlusTree<Key, RecordId, Order, compare>::find_if(Predica
         }
         
         // Move to next leaf
-        leaf = leaf->next_;
+        leaf = next_leaf_shared(leaf, leaf_lock);
     }
     
     return result;
@@ -753,92 +3428,241 @@ DynamicArray<RecordId> BPlusTree<Key, RecordId, Order, compare>::find_if(Predica
 
 
 /**
- * @brief Performs a prefix search in the B+ tree
+ * @brief The shortest byte string greater than every string that starts with prefix
  * 
- * @param prefix The string prefix to search for
+ * @return false if there is none, because prefix is empty or all 0xFF bytes
  * 
  * @details
- * Performs a prefix search by finding the first potential match and then
- * scanning sequentially through leaf nodes until the prefix no longer matches.
+ * Drops the trailing 0xFF bytes, which cannot be incremented, and increments the last
+ * byte that is left: "ab" becomes "ac", "a\xFF" becomes "b".
  */
 
-template <typename Key, typename RecordId, size_t Order, typename compare>
-DynamicArray<RecordId> BPlusTree<Key, RecordId, Order, compare>::prefix_search(const std::string& prefix) {
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+bool BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::prefix_successor(
+    std::string_view prefix, std::string& successor) {
+
+    while (!prefix.empty() && static_cast<unsigned char>(prefix.back()) == 0xFF) {
+        prefix.remove_suffix(1);
+    }
+    if (prefix.empty()) {
+        return false;
+    }
+    successor.assign(prefix);
+    successor.back() = static_cast<char>(static_cast<unsigned char>(successor.back()) + 1);
+    return true;
+}
+
+
+/**
+ * @brief Returns the ids of all keys that start with a byte prefix, in key order
+ * 
+ * @param prefix The leading bytes to match
+ * 
+ * @details
+ * A range scan over [prefix, successor of prefix): one descent to the first candidate,
+ * then one comparison per key against the exclusive upper bound, with no copies of
+ * the keys. For keys that are byte strings ordered by std::less, such as std::string
+ * and NormalizedKey.
+ */
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+DynamicArray<RecordId> BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::prefix_search(std::string_view prefix) {
+    static_assert(std::is_constructible_v<Key, std::string_view> && prefix_searchable<Key, compare>,
+                  "prefix_search(std::string_view) needs byte-string keys ordered by std::less");
 
-    // Acquire shared lock for reading
-    std::shared_lock read_lock(root_mutex_);
     DynamicArray<RecordId> result;
-    
-    // Return empty result if tree is empty
-    if (std::holds_alternative<std::monostate>(root_)) {
+    auto collect = [&result](const Key&, const RecordId& id) {
+        result.push_back(id);
+    };
+
+    std::string successor;
+    if (!prefix_successor(prefix, successor)) {
+        scan_while(Key(prefix), [](const Key&) { return true; }, collect);
         return result;
     }
 
-    // Find the leaf node where the prefix might first appear
-    LeafNodePtr leaf = find_leaf(prefix);
-    
-    // Traverse leaf nodes while checking for prefix matches
-    while (leaf) {
+    const Key bound(std::string_view{successor});
+    scan_while(Key(prefix), [this, &bound](const Key& key) { return comparator_(key, bound); }, collect);
+    return result;
+}
 
-        // Lock current leaf for reading
-        std::shared_lock leaf_lock(leaf->mutex_);
-        
-        // Check each key in the current leaf
-        for (size_t i = 0; i < leaf->keys_.size(); ++i) {
-            const auto& key = leaf->keys_[i];
-        
-            // If key starts with prefix, add to results
-            if (key.substr(0, prefix.size()) == prefix) {
-                result.push_back(leaf->values_[i]);
-            } 
-            // If we've passed possible matches, return results
-            else if (key.substr(0, prefix.size()) > prefix) {
-                return result;
-            }
-        }
-        // Move to next leaf
-        leaf = leaf->next_;
-    }
+
+/**
+ * @brief Returns the ids of all keys whose leading components equal those of prefix
+ * 
+ * @param prefix A CompositeKey of the first components of Key, such as (tenant) or
+ *        (tenant, name) for keys (tenant, name, version)
+ * 
+ * @details
+ * A range scan from the smallest key with these leading components (see
+ * first_key_with_prefix()) that ends at the first key whose leading components
+ * differ. Components are compared in place, so nothing is copied per key.
+ */
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+template <typename... Leading>
+DynamicArray<RecordId> BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::prefix_search(
+    const CompositeKey<Leading...>& prefix) {
+    static_assert(is_leading_prefix<Key, CompositeKey<Leading...>>::value,
+                  "prefix_search needs the leading components of the tree's CompositeKey");
+    static_assert(std::is_same_v<compare, std::less<Key>> || std::is_same_v<compare, std::less<>>,
+                  "prefix_search needs keys ordered by std::less");
+
+    DynamicArray<RecordId> result;
+    scan_while(first_key_with_prefix<Key>(prefix),
+               [&prefix](const Key& key) { return has_prefix(key, prefix); },
+               [&result](const Key&, const RecordId& id) { result.push_back(id); });
     return result;
 }
 
 
-template <typename Key, typename RecordId, size_t Order, typename compare>
-typename BPlusTree<Key, RecordId, Order, compare>::Iterator 
-BPlusTree<Key, RecordId, Order, compare>::begin() {
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+typename BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::Iterator 
+BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::begin() {
 
-    // Acquire shared lock for reading
-    std::shared_lock read_lock(root_mutex_);
+    EpochGuard guard;
 
     // Return empty iterator if tree is empty
-    if (std::holds_alternative<std::monostate>(root_)) {
-        return Iterator();
+    LeafNodeRef current = leftmost_leaf();
+    if (!current) {
+        return Iterator(nullptr, 0, this);
     }
 
-    LeafNodePtr current;
-    // If root is a leaf node, use it directly
-    if (std::holds_alternative<LeafNodePtr>(root_)) {
-        current = std::get<LeafNodePtr>(root_);
-    } 
-    
-    // Otherwise, traverse to leftmost leaf
-    else {
-        auto node = std::get<InternalNodePtr>(root_);
-        // Follow leftmost child pointers until reaching a leaf
-        while (!std::holds_alternative<LeafNodePtr>(node->children_.front())) {
-            node = std::get<InternalNodePtr>(node->children_.front());
-        }
-        current = std::get<LeafNodePtr>(node->children_.front());
+    // Iterators walk the leaves without holding latches or a guard, so any remove()
+    // invalidates them (see Iterator)
+    current->mutex_.unlock_shared();
+
+    // A B-link tree may keep emptied leaves around; start at the first entry
+    Iterator it(current, 0, this);
+    if (current->keys_.empty()) {
+        ++it;
+    }
+    return it;
+}
+
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+typename BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::Iterator 
+BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::end() {
+    return Iterator(nullptr, 0, this);
+}
+
+
+/**
+ * @brief Returns an iterator to the first entry whose key is not less than key
+ * 
+ * @details
+ * One descent to the leftmost leaf that may hold the key plus a binary search in it,
+ * instead of walking from begin(). The iterator is not latched; it is invalidated
+ * like any Iterator.
+ */
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+typename BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::Iterator 
+BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::lower_bound(const Key& key) {
+
+    EpochGuard guard;
+    LeafNodeRef leaf = find_leaf(key);
+    if (!leaf) {
+        return end();
+    }
+    leaf->mutex_.unlock_shared();
+
+    Iterator it(leaf, 0, this);
+    it.seek(key);
+    return it;
+}
+
+
+/**
+ * @brief lower_bound() starting at the leaf a hint remembers
+ * 
+ * @param hint Finger left by an earlier hinted operation; updated to the leaf the
+ *        iterator starts in
+ */
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+typename BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::Iterator 
+BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::lower_bound(const Key& key, SearchHint& hint) {
+
+    EpochGuard guard;
+    LeafNodeRef leaf = latch_search_hint(hint, key, false);
+    if (!leaf && !(leaf = find_leaf(key))) {
+        return end();
+    }
+    remember_leaf(&hint, leaf);
+    leaf->mutex_.unlock_shared();
+
+    Iterator it(leaf, 0, this);
+    it.seek(key);
+    return it;
+}
+
+
+/**
+ * @brief Returns an iterator to the first entry whose key is greater than key
+ * 
+ * @details
+ * Duplicates of the key may continue over several leaves; the iterator walks past
+ * them from the leaf the descent ends in.
+ */
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+typename BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::Iterator 
+BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::upper_bound(const Key& key) {
+
+    EpochGuard guard;
+    LeafNodeRef leaf = find_leaf(key);
+    if (!leaf) {
+        return end();
     }
+    leaf->mutex_.unlock_shared();
+
+    Iterator it(leaf, 0, this);
+    it.seek_past(key);
+    return it;
+}
+
 
-    return Iterator(current, 0);
+/**
+ * @brief Returns the entries with keys equal to key as [lower_bound, upper_bound)
+ * 
+ * @details
+ * Both iterators come from a single descent; the upper one is found by walking on
+ * from the lower one.
+ */
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+std::pair<typename BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::Iterator,
+          typename BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::Iterator>
+BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::equal_range(const Key& key) {
+
+    Iterator first = lower_bound(key);
+    Iterator last = first;
+    last.seek_past(key);
+    return {first, last};
+}
+
+
+/**
+ * @brief Reverse iterators over the whole tree, from the largest key down
+ * 
+ * @details
+ * Built on Iterator::operator--, which walks the prev_ links. The same invalidation
+ * rules as for begin() and end() apply.
+ */
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+typename BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::ReverseIterator 
+BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::rbegin() {
+    return ReverseIterator(end());
 }
 
 
-template <typename Key, typename RecordId, size_t Order, typename compare>
-typename BPlusTree<Key, RecordId, Order, compare>::Iterator 
-BPlusTree<Key, RecordId, Order, compare>::end() {
-    return Iterator();
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+typename BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::ReverseIterator 
+BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::rend() {
+    return ReverseIterator(begin());
 }
 
 
@@ -852,41 +3676,29 @@ BPlusTree<Key, RecordId, Order, compare>::end() {
  * Calculates tree height by traversing from root to leftmost leaf.
  */
 
-template <typename Key, typename RecordId, size_t Order, typename compare>
-size_t BPlusTree<Key, RecordId, Order, compare>::height() const {
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+size_t BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::height() const {
 
-    // Acquire shared lock for reading
-    std::shared_lock read_lock(root_mutex_);
-    
-    if (std::holds_alternative<std::monostate>(root_)) {
+    EpochGuard guard;
+    NodeRef node;
+    {
+        // Acquire shared lock for reading the root
+        std::shared_lock read_lock(root_mutex_);
+        node = ref_of(root_);
+    }
+
+    if (std::holds_alternative<std::monostate>(node)) {
         return 0;  
     }
-    
-    size_t h = 1; 
-    
-    // If root is internal node, traverse to leaf counting levels
-    if (std::holds_alternative<InternalNodePtr>(root_)) {
-        auto current = std::get<InternalNodePtr>(root_);
-        
-        while (current) {
-            h++;
-            
-            // Break if node has no children
-            if (current->children_.empty()) {
-                break;
-            }
-            
-            // Get first child of current node
-            const auto& first_child = current->children_[0];
 
-            // Break if we've reached a leaf level
-            if (std::holds_alternative<LeafNodePtr>(first_child)) {
-                break;
-            }
-            
-            // Move to next level
-            current = std::get<InternalNodePtr>(first_child);
-        }
+    // Walk the first children one latch at a time; B-link writers latch bottom-up,
+    // so holding a parent while waiting for a child could deadlock against them
+    size_t h = 1; 
+    while (std::holds_alternative<InternalNodeRef>(node)) {
+        InternalNodeRef current = std::get<InternalNodeRef>(node);
+        std::shared_lock<OptimisticLatch> node_lock(current->mutex_);
+        node = ref_of(current->children_[0]);
+        h++;
     }
     
     return h;
@@ -904,47 +3716,60 @@ size_t BPlusTree<Key, RecordId, Order, compare>::height() const {
  * Fill factor = total keys used / total possible keys
  */
 
-template <typename Key, typename RecordId, size_t Order, typename compare>
-double BPlusTree<Key, RecordId, Order, compare>::fill_factor() const {
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+double BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::fill_factor() const {
 
-    // Acquire shared lock for reading
-    std::shared_lock read_lock(root_mutex_);
+    EpochGuard guard;
+    NodeRef root;
+    {
+        // Acquire shared lock for reading the root
+        std::shared_lock read_lock(root_mutex_);
+        root = ref_of(root_);
+    }
     
     // Return 0 if tree is empty
-    if (std::holds_alternative<std::monostate>(root_)) {
+    if (std::holds_alternative<std::monostate>(root)) {
         return 0.0;  
     }
     
     size_t total_capacity = 0;
     size_t total_used = 0;
     
-    // Define recursive lambda function to calculate fill factor
-    std::function<void(const VariantNode<Key, RecordId, Order>&)> calculate_fill =
-        [&](const VariantNode<Key, RecordId, Order>& node) {
+    // Define recursive lambda function to calculate fill factor. Each node is latched
+    // only while it is read; its children are visited after the latch is released.
+    std::function<void(const NodeRef&)> calculate_fill =
+        [&](const NodeRef& node) {
             
-            if (std::holds_alternative<LeafNodePtr>(node)) {
+            if (std::holds_alternative<LeafNodeRef>(node)) {
         
                 // Handle leaf node
-                auto leaf = std::get<LeafNodePtr>(node);
+                LeafNodeRef leaf = std::get<LeafNodeRef>(node);
+                std::shared_lock<OptimisticLatch> leaf_lock(leaf->mutex_);
                 total_capacity += Order - 1;  // Maximum keys possible
                 total_used += leaf->keys_.size();  // Current keys
             }
-            else if (std::holds_alternative<InternalNodePtr>(node)) {
+            else if (std::holds_alternative<InternalNodeRef>(node)) {
                 // Handle internal node
-                auto internal = std::get<InternalNodePtr>(node);
-            
-                total_capacity += Order - 1;  // Maximum keys possible
-                total_used += internal->keys_.size();  // Current keys
+                InternalNodeRef internal = std::get<InternalNodeRef>(node);
+                DynamicArray<NodeRef> children;
+                {
+                    std::shared_lock<OptimisticLatch> node_lock(internal->mutex_);
+                    total_capacity += InternalOrder - 1;  // Maximum keys possible
+                    total_used += internal->keys_.size();  // Current keys
+                    for (const auto& child : internal->children_) {
+                        children.push_back(ref_of(child));
+                    }
+                }
                 
                 // Recursively process all children
-                for (const auto& child : internal->children_) {
+                for (const auto& child : children) {
                     calculate_fill(child);
                 }
             }
         };
     
     // Calculate fill factor starting from root
-    calculate_fill(root_);
+    calculate_fill(root);
     
     // Return ratio of used space to total capacity
     return total_capacity > 0 ? static_cast<double>(total_used) / total_capacity : 0.0;
@@ -952,28 +3777,95 @@ double BPlusTree<Key, RecordId, Order, compare>::fill_factor() const {
 
 
 
+/**
+ * @brief Creates an empty tree
+ * 
+ * @param mode How concurrent writers coordinate
+ * @param counts Whether internal nodes keep subtree counts for count(), rank() and select()
+ * 
+ * @throws std::invalid_argument if subtree counts are requested for a B-link tree, whose
+ *         writers never latch the path above the leaf they change
+ */
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::BPlusTree(ConcurrencyMode mode, SubtreeCounts counts)
+    : root_(nullptr), size_(0), comparator_(), mode_(mode), counted_(counts == SubtreeCounts::On) {
+
+    if (counted_ && mode_ == ConcurrencyMode::BLink) {
+        throw std::invalid_argument("subtree counts require ConcurrencyMode::LatchCoupling");
+    }
+}
+
+
+
+/**
+ * @brief Creates an empty tree whose nodes are allocated from a memory resource
+ * 
+ * @param resource Passed to the NodeAllocator policy: HeapNodeAllocator allocates each
+ *        node from it, SlabNodeAllocator takes its slabs from it. It must outlive every
+ *        node of the tree, including those moved into another tree.
+ * @param mode, counts As for the constructor above
+ * 
+ * @details
+ * A tree that lives no longer than a request can draw on a monotonic_buffer_resource,
+ * so that the memory of all its nodes goes back in a single release of the buffer.
+ */
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::BPlusTree(
+    std::pmr::memory_resource* resource, ConcurrencyMode mode, SubtreeCounts counts)
+    : BPlusTree(mode, counts) {
+    allocator_ = NodeAllocator(resource);
+}
+
+
+
 /**
  * @brief Copy constructor for BPlusTree.
  *
  * Creates a deep copy of the BPlusTree, including all nodes and their contents.
  */
 
-template <typename Key, typename RecordId, size_t Order, typename compare>
-BPlusTree<Key, RecordId, Order, compare>::BPlusTree(const BPlusTree& other)
-    : size_(other.size_), comparator_(other.comparator_) {
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::BPlusTree(const BPlusTree& other)
+    : allocator_(other.allocator_), size_(other.size_.load()), comparator_(other.comparator_), mode_(other.mode_),
+      counted_(other.counted_) {
+
+    // B-link writers latch bottom-up, so the source cannot be copied under nested latches.
+    // It is read one leaf at a time instead, left to right, and the entries re-inserted.
+    EpochGuard guard;
+
+    if (mode_ == ConcurrencyMode::BLink) {
+        root_ = nullptr;
+        size_ = 0;
+
+        LeafNodeRef leaf = other.leftmost_leaf();
+        if (!leaf) {
+            return;
+        }
+        std::shared_lock<OptimisticLatch> leaf_lock(leaf->mutex_, std::adopt_lock);
+        while (leaf) {
+            for (size_t i = 0; i < leaf->keys_.size(); ++i) {
+                insert(leaf->keys_[i], leaf->values_[i]);
+            }
+            leaf = next_leaf_shared(leaf, leaf_lock);
+        }
+        return;
+    }
 
     // Acquire a shared lock on the other tree's root mutex 
     std::shared_lock read_lock(other.root_mutex_);
     
-    if (std::holds_alternative<std::monostate>(other.root_)) {
-        root_ = std::monostate{};
+    if (!other.root_) {
+        root_ = nullptr;
         return;
     }
 
     // If the other tree's root is a leaf node, create a new leaf node and copy its contents.
-    if (std::holds_alternative<LeafNodePtr>(other.root_)) {
-        auto other_leaf = std::get<LeafNodePtr>(other.root_);
-        auto new_leaf = make_shared<LeafNode<Key, RecordId, Order>>();
+    if (other.root_.is_leaf()) {
+        auto other_leaf = other.root_.leaf_ptr();
+        std::shared_lock<OptimisticLatch> leaf_lock(other_leaf->mutex_);
+        auto new_leaf = make_leaf();
         
         // Copy the keys and values from the other leaf node.
         new_leaf->keys_ = other_leaf->keys_;
@@ -986,11 +3878,11 @@ BPlusTree<Key, RecordId, Order, compare>::BPlusTree(const BPlusTree& other)
         root_ = new_leaf;
     } else {
         // If the other tree's root is an internal node, recursively copy the entire subtree using the deep_copy_node function.
-        root_ = deep_copy_node(std::get<InternalNodePtr>(other.root_));
+        root_ = deep_copy_node(other.root_.internal());
     }
 
-    // Rebuild the leaf links to ensure they are correct in the new tree.
-    rebuild_leaf_links();
+    // Rebuild the sibling links to ensure they are correct in the new tree.
+    rebuild_sibling_links();
 }
 
 
@@ -1001,27 +3893,32 @@ BPlusTree<Key, RecordId, Order, compare>::BPlusTree(const BPlusTree& other)
  * Transfers ownership of the BPlusTree from the other tree to this one.
  */
 
-template <typename Key, typename RecordId, size_t Order, typename compare>
-BPlusTree<Key, RecordId, Order, compare>::BPlusTree(BPlusTree&& other) noexcept
-    : root_(std::monostate{}), size_(0), comparator_() {
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::BPlusTree(BPlusTree&& other) noexcept
+    : root_(nullptr), size_(0), comparator_() {
 
     // Acquire an exclusive lock on the other tree's root mutex
     std::unique_lock write_lock(other.root_mutex_);
     
+    allocator_ = std::move(other.allocator_);
     root_ = std::move(other.root_);
-    size_ = other.size_;
+    size_ = other.size_.load();
     comparator_ = std::move(other.comparator_);
+    mode_ = other.mode_;
+    counted_ = other.counted_;
+    other.append_hint_.store(nullptr);
+    other.retirements_.fetch_add(1);  // its SearchHints now point into this tree
     
     // Reset the other tree's members to their default values.
-    other.root_ = std::monostate{};
+    other.root_ = nullptr;
     other.size_ = 0;
 }
 
 
 
-template <typename Key, typename RecordId, size_t Order, typename compare>
-BPlusTree<Key, RecordId, Order, compare>& 
-BPlusTree<Key, RecordId, Order, compare>::operator=(const BPlusTree& other) {
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>& 
+BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::operator=(const BPlusTree& other) {
     if (this != &other) {
         BPlusTree temp(other);
         *this = std::move(temp);
@@ -1031,21 +3928,28 @@ BPlusTree<Key, RecordId, Order, compare>::operator=(const BPlusTree& other) {
 
 
 
-template <typename Key, typename RecordId, size_t Order, typename compare>
-BPlusTree<Key, RecordId, Order, compare>& 
-BPlusTree<Key, RecordId, Order, compare>::operator=(BPlusTree&& other) noexcept {
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>& 
+BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::operator=(BPlusTree&& other) noexcept {
 
     if (this != &other) {
         std::unique_lock write_lock1(root_mutex_, std::defer_lock);
         std::unique_lock write_lock2(other.root_mutex_, std::defer_lock);
         std::lock(write_lock1, write_lock2);
         
-        clear();
+        // Both root latches are already held here, so clear() would self-deadlock
+        append_hint_.store(nullptr);
+        other.append_hint_.store(nullptr);
+        other.retirements_.fetch_add(1);
+        retire(std::move(root_));
+        allocator_ = std::move(other.allocator_);
         root_ = std::move(other.root_);
-        size_ = other.size_;
+        size_ = other.size_.load();
         comparator_ = std::move(other.comparator_);
+        mode_ = other.mode_;
+        counted_ = other.counted_;
         
-        other.root_ = std::monostate{};
+        other.root_ = nullptr;
         other.size_ = 0;
     }
     return *this;
@@ -1062,35 +3966,45 @@ BPlusTree<Key, RecordId, Order, compare>::operator=(BPlusTree&& other) noexcept
  * @return A shared pointer to the new internal node.
  */
 
-template <typename Key, typename RecordId, size_t Order, typename compare>
-typename BPlusTree<Key, RecordId, Order, compare>::InternalNodePtr
-BPlusTree<Key, RecordId, Order, compare>::deep_copy_node(const InternalNodePtr& node) {
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+typename BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::InternalNodePtr
+BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::deep_copy_node(InternalNodeRef node) {
 
     // If the node is nullptr, return nullptr.
     if (!node) return nullptr;
 
+    // Keep the source node stable while it is copied.
+    std::shared_lock<OptimisticLatch> node_lock(node->mutex_);
+
     // Create a new internal node.
-    auto new_node = make_shared<InternalNode<Key, RecordId, Order>>();
+    auto new_node = make_internal();
     
-    // Copy the keys from the original node.
+    // Copy the keys and bounds from the original node.
     new_node->keys_ = node->keys_;
+    new_node->counts_ = node->counts_;
+    new_node->high_key_ = node->high_key_;
+    new_node->has_high_key_ = node->has_high_key_;
+    new_node->level_ = node->level_;
 
     // Iterate over the children of the original node.
     for (const auto& child : node->children_) {
     
         // If the child is an internal node, recursively copy it.
-        if (std::holds_alternative<InternalNodePtr>(child)) {
-            new_node->children_.push_back(deep_copy_node(std::get<InternalNodePtr>(child)));
+        if (child.is_internal()) {
+            new_node->children_.push_back(deep_copy_node(child.internal()));
 
         // If the child is a leaf node, create a new leaf node and copy its contents.
-        } else if (std::holds_alternative<LeafNodePtr>(child)) {
+        } else if (child.is_leaf()) {
         
-            auto leaf = std::get<LeafNodePtr>(child);
-            auto new_leaf = make_shared<LeafNode<Key, RecordId, Order>>();
+            LeafNodeRef leaf = child.leaf();
+            std::shared_lock<OptimisticLatch> leaf_lock(leaf->mutex_);
+            auto new_leaf = make_leaf();
             
-            // Copy the keys and values from the original leaf node.
+            // Copy the keys, values and bound from the original leaf node.
             new_leaf->keys_ = leaf->keys_;
             new_leaf->values_ = leaf->values_;
+            new_leaf->high_key_ = leaf->high_key_;
+            new_leaf->has_high_key_ = leaf->has_high_key_;
         
             // Set the next pointer to nullptr, as this is a new leaf node.
             new_leaf->next_ = nullptr;  
@@ -1107,60 +4021,47 @@ BPlusTree<Key, RecordId, Order, compare>::deep_copy_node(const InternalNodePtr&
 
 
 /**
- * @brief Rebuilds the leaf links in the BPlusTree.
+ * @brief Rebuilds the sibling links in the BPlusTree.
  *
- * Iterates over all leaf nodes and sets the next pointer of each node to the
- * next node in the sequence.
+ * Walks the tree level by level and links every node to the next node on
+ * the same level: leaves through next_ and prev_, internal nodes through right_.
  */
 
-template <typename Key, typename RecordId, size_t Order, typename compare>
-void BPlusTree<Key, RecordId, Order, compare>::rebuild_leaf_links() {
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+void BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::rebuild_sibling_links() {
 
-    // If the tree is empty, return immediately.
-    if (std::holds_alternative<std::monostate>(root_)) return;
+    DynamicArray<VariantNode<Key, RecordId, Order, InternalOrder>> level;
+    level.push_back(root_);
 
-    DynamicArray<LeafNodePtr> leaves;
-    collect_leaves(root_, leaves);
+    while (level[0].is_internal()) {
+        DynamicArray<VariantNode<Key, RecordId, Order, InternalOrder>> below;
 
-    // Iterate over the leaf nodes and set the next pointer of each node.
-    for (size_t i = 0; i < leaves.size() - 1; ++i) {
-        leaves[i]->next_ = leaves[i + 1];
+        for (size_t i = 0; i < level.size(); ++i) {
+            auto node = level[i].internal_ptr();
+            if (i + 1 < level.size()) {
+                node->right_ = level[i + 1].internal_ptr();
+            }
+            for (const auto& child : node->children_) {
+                below.push_back(child);
+            }
+        }
+        level = std::move(below);
     }
-}
-
-
-
-/**
- * @brief Recursively collects all leaf nodes in the BPlusTree.
- *
- * Iterates over all nodes in the tree and adds any leaf nodes to the given vector.
- *
- * @param node The current node to process.
- */
 
-template <typename Key, typename RecordId, size_t Order, typename compare>
-void BPlusTree<Key, RecordId, Order, compare>::collect_leaves(
-    const VariantNode<Key, RecordId, Order>& node, 
-    DynamicArray<LeafNodePtr>& leaves) {
-    
-    // If the node is a leaf node, add it to the vector.
-    if (std::holds_alternative<LeafNodePtr>(node)) {
-        leaves.push_back(std::get<LeafNodePtr>(node));
-
-    // If the node is an internal node, recursively process its children.
-    } else if (std::holds_alternative<InternalNodePtr>(node)) {
-    
-        auto internal = std::get<InternalNodePtr>(node);
-        for (const auto& child : internal->children_) {
-            collect_leaves(child, leaves);
-        }
+    // Iterate over the leaf nodes and link each one with its neighbours.
+    for (size_t i = 0; i + 1 < level.size(); ++i) {
+        level[i].leaf()->next_ = level[i + 1].leaf_ptr();
+        level[i + 1].leaf()->prev_.store(level[i].leaf(),
+                                                         std::memory_order_relaxed);
     }
 }
 
 
-template <typename Key, typename RecordId, size_t Order, typename compare>
-void BPlusTree<Key, RecordId, Order, compare>::clear() {
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+void BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::clear() {
     std::unique_lock write_lock(root_mutex_);
-    root_ = std::monostate{};
+    append_hint_.store(nullptr);
+    retire(std::move(root_));
+    root_ = nullptr;
     size_ = 0;
 }
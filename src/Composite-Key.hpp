@@ -2,6 +2,7 @@
 
 #include <cstddef>
 #include <tuple>
+#include <type_traits>
 
 template <typename... Keys>
 struct CompositeKey {
@@ -22,3 +23,42 @@ struct CompositeKey {
     bool operator>(const CompositeKey& other) const;
     bool operator==(const CompositeKey& other) const;
 };
+
+
+/**
+ * @brief Whether Prefix is a CompositeKey of the leading component types of Key
+ */
+template <typename Key, typename Prefix>
+struct is_leading_prefix : std::false_type {};
+
+template <typename... Keys, typename... Leading>
+struct is_leading_prefix<CompositeKey<Keys...>, CompositeKey<Leading...>> {
+    static constexpr bool value = [] {
+        if constexpr (sizeof...(Leading) > sizeof...(Keys)) {
+            return false;
+        } else {
+            return []<size_t... I>(std::index_sequence<I...>) {
+                return (std::is_same_v<Leading, std::tuple_element_t<I, std::tuple<Keys...>>> && ...);
+            }(std::index_sequence_for<Leading...>{});
+        }
+    }();
+};
+
+
+/**
+ * @brief The smallest key that starts with the components of prefix
+ *
+ * @details
+ * The remaining components take their smallest value: the lowest value of arithmetic
+ * types, negative infinity for floating point, and the default for any other type,
+ * which has to be its smallest (as the empty string is).
+ */
+template <typename Key, typename... Leading>
+Key first_key_with_prefix(const CompositeKey<Leading...>& prefix);
+
+
+/**
+ * @brief Whether the leading components of key equal those of prefix
+ */
+template <typename... Keys, typename... Leading>
+bool has_prefix(const CompositeKey<Keys...>& key, const CompositeKey<Leading...>& prefix);
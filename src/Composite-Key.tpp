@@ -1,4 +1,6 @@
 #include "BP-Tree.hpp"
+#include <limits>
+#include <utility>
 
 // ------------------------- COMPOSITE KEY IMPLEMENTATION --------------------------
 
@@ -29,3 +31,37 @@ template <typename... Keys>
 bool CompositeKey<Keys...>::operator==(const CompositeKey& other) const {
     return parameters_ == other.parameters_;
 }
+
+
+template <typename Key, typename... Leading>
+Key first_key_with_prefix(const CompositeKey<Leading...>& prefix) {
+    static_assert(is_leading_prefix<Key, CompositeKey<Leading...>>::value,
+                  "the prefix must hold the leading components of the key");
+
+    Key key;
+    [&]<size_t... I>(std::index_sequence<I...>) {
+        auto fill = [&]<size_t J>(std::integral_constant<size_t, J>) {
+            auto& component = std::get<J>(key.parameters_);
+            using Component = std::decay_t<decltype(component)>;
+            if constexpr (J < sizeof...(Leading)) {
+                component = std::get<J>(prefix.parameters_);
+            } else if constexpr (std::numeric_limits<Component>::has_infinity) {
+                component = -std::numeric_limits<Component>::infinity();
+            } else if constexpr (std::numeric_limits<Component>::is_specialized) {
+                component = std::numeric_limits<Component>::lowest();
+            } else {
+                component = Component();
+            }
+        };
+        (fill(std::integral_constant<size_t, I>{}), ...);
+    }(std::make_index_sequence<std::tuple_size_v<decltype(key.parameters_)>>{});
+    return key;
+}
+
+
+template <typename... Keys, typename... Leading>
+bool has_prefix(const CompositeKey<Keys...>& key, const CompositeKey<Leading...>& prefix) {
+    return [&]<size_t... I>(std::index_sequence<I...>) {
+        return ((std::get<I>(key.parameters_) == std::get<I>(prefix.parameters_)) && ...);
+    }(std::index_sequence_for<Leading...>{});
+}
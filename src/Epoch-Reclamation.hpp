@@ -0,0 +1,142 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+
+
+/**
+ * @brief Process-wide epoch-based reclamation domain
+ *
+ * @details
+ * Threads that dereference shared nodes through raw pointers do so inside an
+ * EpochGuard. Entering a guard publishes the current global epoch in a per-thread
+ * slot; leaving it clears the slot. A node that has been unlinked is tagged with
+ * retire_epoch() and may be freed once min_active_epoch() is greater than the tag:
+ * every thread that could still hold a pointer to it has left its guard by then.
+ *
+ * Slots are allocated on a thread's first guard, reused after the thread exits and
+ * never freed, so scanning them needs no locking.
+ */
+
+class EpochDomain {
+  private:
+
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> epoch{0};  // 0 while the owning thread is outside any guard
+        std::atomic<bool> in_use{false};
+        size_t depth = 0;                // guard nesting, only touched by the owning thread
+        Slot* next = nullptr;
+    };
+
+    struct SlotOwner {
+        Slot* slot = nullptr;
+        ~SlotOwner() {
+            if (slot) {
+                slot->in_use.store(false, std::memory_order_release);
+            }
+        }
+    };
+
+    std::atomic<uint64_t> epoch_{1};
+    std::atomic<Slot*> slots_{nullptr};
+
+    EpochDomain() = default;
+
+    Slot* thread_slot() {
+        thread_local SlotOwner owner;
+        if (owner.slot) {
+            return owner.slot;
+        }
+
+        // Reuse a slot left behind by an exited thread before allocating a new one
+        for (Slot* slot = slots_.load(std::memory_order_acquire); slot; slot = slot->next) {
+            bool expected = false;
+            if (!slot->in_use.load(std::memory_order_relaxed) &&
+                slot->in_use.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+                owner.slot = slot;
+                return slot;
+            }
+        }
+
+        Slot* slot = new Slot();
+        slot->in_use.store(true, std::memory_order_relaxed);
+        slot->next = slots_.load(std::memory_order_relaxed);
+        while (!slots_.compare_exchange_weak(slot->next, slot, std::memory_order_acq_rel)) {
+        }
+        owner.slot = slot;
+        return slot;
+    }
+
+  public:
+
+    EpochDomain(const EpochDomain&) = delete;
+    EpochDomain& operator=(const EpochDomain&) = delete;
+
+    static EpochDomain& global() {
+        // Never destroyed, so guards in threads that outlive static destruction stay valid
+        static EpochDomain* domain = new EpochDomain();
+        return *domain;
+    }
+
+    void enter() {
+        Slot* slot = thread_slot();
+        if (slot->depth++ == 0) {
+            slot->epoch.store(epoch_.load(std::memory_order_acquire), std::memory_order_relaxed);
+            // The published epoch must be visible before any shared pointer is read
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+        }
+    }
+
+    void leave() {
+        Slot* slot = thread_slot();
+        if (--slot->depth == 0) {
+            slot->epoch.store(0, std::memory_order_release);
+        }
+    }
+
+    /**
+     * @brief Returns the tag for an object that has just been unlinked
+     *
+     * @details
+     * Advances the global epoch, so threads entering afterwards cannot reach the object.
+     */
+    uint64_t retire_epoch() {
+        return epoch_.fetch_add(1, std::memory_order_acq_rel);
+    }
+
+    /**
+     * @brief Oldest epoch published by a thread that is inside a guard
+     *
+     * @return The oldest active epoch, or the maximum value if no thread is inside a guard
+     */
+    uint64_t min_active_epoch() const {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        uint64_t min_epoch = std::numeric_limits<uint64_t>::max();
+        for (Slot* slot = slots_.load(std::memory_order_acquire); slot; slot = slot->next) {
+            uint64_t epoch = slot->epoch.load(std::memory_order_acquire);
+            if (epoch != 0 && epoch < min_epoch) {
+                min_epoch = epoch;
+            }
+        }
+        return min_epoch;
+    }
+};
+
+
+/**
+ * @brief Keeps the calling thread inside an epoch of the global domain for its lifetime
+ *
+ * @details
+ * Guards nest; only the outermost one publishes and clears the epoch.
+ */
+
+class EpochGuard {
+  public:
+    EpochGuard() { EpochDomain::global().enter(); }
+    ~EpochGuard() { EpochDomain::global().leave(); }
+
+    EpochGuard(const EpochGuard&) = delete;
+    EpochGuard& operator=(const EpochGuard&) = delete;
+};
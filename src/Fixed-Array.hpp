@@ -0,0 +1,78 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+
+/**
+ * @brief Sequence container with a compile-time capacity, stored inline
+ *
+ * @details
+ * Holds up to Capacity elements in an embedded std::array, so a node that keeps its
+ * keys, values and children in FixedArrays is a single contiguous allocation. The
+ * interface is the subset of DynamicArray that the tree uses; iterators are plain
+ * pointers and are never invalidated by a reallocation, because there is none.
+ *
+ * Slots past size() hold value-initialized elements. Removing an element resets the
+ * slot it vacates, so owning element types (such as child pointers) are released
+ * immediately rather than when the slot is next overwritten.
+ *
+ * @tparam T Element type; must be default-constructible
+ * @tparam Capacity Maximum number of elements
+ *
+ * @note Growing past Capacity is a precondition violation and is not checked
+ */
+
+template <typename T, size_t Capacity>
+class FixedArray {
+  private:
+
+    std::array<T, Capacity> data_{};
+    size_t size_ = 0;
+
+  public:
+
+    using value_type = T;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    FixedArray() = default;
+
+    static constexpr size_t capacity() noexcept { return Capacity; }
+
+    size_t size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0; }
+
+    iterator begin() noexcept { return data_.data(); }
+    iterator end() noexcept { return data_.data() + size_; }
+    const_iterator begin() const noexcept { return data_.data(); }
+    const_iterator end() const noexcept { return data_.data() + size_; }
+
+    T& operator[](size_t index) noexcept { return data_[index]; }
+    const T& operator[](size_t index) const noexcept { return data_[index]; }
+
+    T& front() noexcept { return data_[0]; }
+    const T& front() const noexcept { return data_[0]; }
+    T& back() noexcept { return data_[size_ - 1]; }
+    const T& back() const noexcept { return data_[size_ - 1]; }
+
+    void push_back(const T& value);
+    void push_back(T&& value);
+    void pop_back();
+
+    iterator insert(const_iterator pos, const T& value);
+    iterator insert(const_iterator pos, T&& value);
+
+    template <typename InputIt>
+    iterator insert(const_iterator pos, InputIt first, InputIt last);
+
+    iterator erase(const_iterator pos);
+
+    template <typename InputIt>
+    void assign(InputIt first, InputIt last);
+
+    void resize(size_t count);
+    void clear();
+};
+
+#include "Fixed-Array.tpp"
@@ -0,0 +1,110 @@
+#include "Fixed-Array.hpp"
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+// ------------------------- FIXED ARRAY IMPLEMENTATION --------------------------
+
+
+template <typename T, size_t Capacity>
+void FixedArray<T, Capacity>::push_back(const T& value) {
+    data_[size_++] = value;
+}
+
+template <typename T, size_t Capacity>
+void FixedArray<T, Capacity>::push_back(T&& value) {
+    data_[size_++] = std::move(value);
+}
+
+template <typename T, size_t Capacity>
+void FixedArray<T, Capacity>::pop_back() {
+    data_[--size_] = T();
+}
+
+
+/**
+ * @brief Inserts an element before pos, shifting the tail one slot to the right
+ *
+ * @return Iterator to the inserted element
+ */
+
+template <typename T, size_t Capacity>
+typename FixedArray<T, Capacity>::iterator
+FixedArray<T, Capacity>::insert(const_iterator pos, const T& value) {
+    T copy = value;  // value may live in the range that is about to shift
+    return insert(pos, std::move(copy));
+}
+
+template <typename T, size_t Capacity>
+typename FixedArray<T, Capacity>::iterator
+FixedArray<T, Capacity>::insert(const_iterator pos, T&& value) {
+    iterator target = begin() + (pos - begin());
+    std::move_backward(target, end(), end() + 1);
+    *target = std::move(value);
+    ++size_;
+    return target;
+}
+
+
+/**
+ * @brief Inserts the elements of [first, last) before pos
+ *
+ * @return Iterator to the first inserted element
+ */
+
+template <typename T, size_t Capacity>
+template <typename InputIt>
+typename FixedArray<T, Capacity>::iterator
+FixedArray<T, Capacity>::insert(const_iterator pos, InputIt first, InputIt last) {
+    iterator target = begin() + (pos - begin());
+    size_t count = static_cast<size_t>(std::distance(first, last));
+    std::move_backward(target, end(), end() + count);
+    std::copy(first, last, target);
+    size_ += count;
+    return target;
+}
+
+
+/**
+ * @brief Removes the element at pos, shifting the tail one slot to the left
+ *
+ * @return Iterator to the element that followed the removed one
+ */
+
+template <typename T, size_t Capacity>
+typename FixedArray<T, Capacity>::iterator
+FixedArray<T, Capacity>::erase(const_iterator pos) {
+    iterator target = begin() + (pos - begin());
+    std::move(target + 1, end(), target);
+    pop_back();
+    return target;
+}
+
+
+template <typename T, size_t Capacity>
+template <typename InputIt>
+void FixedArray<T, Capacity>::assign(InputIt first, InputIt last) {
+    clear();
+    for (; first != last; ++first) {
+        data_[size_++] = *first;
+    }
+}
+
+
+/**
+ * @brief Shrinks to count elements, or grows with value-initialized ones
+ */
+
+template <typename T, size_t Capacity>
+void FixedArray<T, Capacity>::resize(size_t count) {
+    for (size_t i = count; i < size_; ++i) {
+        data_[i] = T();
+    }
+    size_ = count;
+}
+
+
+template <typename T, size_t Capacity>
+void FixedArray<T, Capacity>::clear() {
+    resize(0);
+}
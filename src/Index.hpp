@@ -1,6 +1,12 @@
 #pragma once
 #include "BP-Tree.hpp"
 #include "Composite-Key.hpp"
+#include <algorithm>
+#include <memory_resource>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 template<typename... Fields>
 class Record {
@@ -50,15 +56,26 @@ class Index {
   protected:
     mutable BPlusTree<KeyType, size_t, 128, Compare> tree_; // B+ tree for indexing.
     
-    mutable DynamicArray<RecordType> records_; // Dynamic array storing all records.
+    mutable std::pmr::vector<RecordType> records_; // All records, indexed by id.
     
     std::function<KeyType(const RecordType&)> key_extractor_; // Function to extract keys from records.
 
   public:
+
+    using RangeCursor = typename BPlusTree<KeyType, size_t, 128, Compare>::RangeCursor;
     
     Index(std::function<KeyType(const RecordType&)> key_extractor) 
         : key_extractor_(key_extractor) {}
 
+    /**
+     * @brief Constructs an index whose records and tree nodes live in a memory resource.
+     *
+     * @param resource Must outlive the index; shared with other threads only if it is
+     *        thread-safe.
+     */
+    Index(std::function<KeyType(const RecordType&)> key_extractor, std::pmr::memory_resource* resource)
+        : tree_(resource), records_(resource), key_extractor_(key_extractor) {}
+
     /**
      * @brief Inserts a record into the index.
      */
@@ -67,6 +84,37 @@ class Index {
         tree_.insert(key_extractor_(record), record.get_id());
     }
 
+    /**
+     * @brief Populates an empty index from a range of records in one pass.
+     *
+     * @param first, last The records, in any order.
+     * @param fill_factor Share of each tree node to fill (see BPlusTree::bulk_load).
+     *
+     * @throws std::logic_error if the index already holds records.
+     * @throws std::invalid_argument if the tree rejects the load; the index stays empty.
+     */
+    template<typename InputIt>
+    void bulk_load(InputIt first, InputIt last, double fill_factor = 1.0) {
+        if (records_.size() != 0) {
+            throw std::logic_error("bulk_load requires an empty index");
+        }
+
+        std::vector<std::pair<KeyType, size_t>> entries;
+        // The records are only kept once the tree has accepted them
+        std::pmr::vector<RecordType> loaded(records_.get_allocator());
+        for (; first != last; ++first) {
+            loaded.push_back(*first);
+            entries.emplace_back(key_extractor_(*first), first->get_id());
+        }
+
+        Compare compare;
+        std::stable_sort(entries.begin(), entries.end(), [&compare](const auto& a, const auto& b) {
+            return compare(a.first, b.first);
+        });
+        tree_.bulk_load(entries.begin(), entries.end(), fill_factor);
+        records_.swap(loaded);
+    }
+
     /**
      * @brief Removes a record from the index by key.
      */
@@ -128,6 +176,43 @@ class Index {
         return result;
     }
 
+    /**
+     * @brief Returns the next page of at most limit records within a key range.
+     *
+     * @param cursor Where the previous page ended; a default-constructed cursor starts
+     *        at the lower bound. Updated to where this page ends.
+     * @return A DynamicArray of up to limit records.
+     */
+    DynamicArray<RecordType> range_search(const KeyType& from, const KeyType& to,
+                                          size_t limit, RangeCursor& cursor) const {
+        DynamicArray<RecordType> result;
+        auto record_ids = tree_.range_search(from, to, limit, cursor);
+        for (const auto& id : record_ids) {
+            result.push_back(records_[id]);
+        }
+        return result;
+    }
+
+    /**
+     * @brief Streams the records with keys in [from, to] to a visitor, in key order.
+     *
+     * @param visitor Called with each record; if it returns bool, false stops the scan.
+     * @return The number of records visited.
+     *
+     * Unlike range_search, no result array is built. The visitor must not modify the index.
+     */
+    template<typename Visitor>
+    size_t scan(const KeyType& from, const KeyType& to, Visitor&& visitor) const {
+        return tree_.scan(from, to, [this, &visitor](const KeyType&, const size_t& id) {
+            if constexpr (std::is_same_v<std::invoke_result_t<Visitor&, const RecordType&>, bool>) {
+                return visitor(records_[id]);
+            } else {
+                visitor(records_[id]);
+                return true;
+            }
+        });
+    }
+
     /**
      * @brief Finds all records that satisfy a given predicate.
      *
@@ -177,7 +262,7 @@ class CompositeIndex {
   private:
     mutable BPlusTree<CompositeKey<Keys...>, size_t> tree_; ///< B+ tree for indexing with composite keys.
 
-    mutable DynamicArray<RecordType> records_; 
+    mutable std::pmr::vector<RecordType> records_; 
     
     std::tuple<std::function<Keys(const RecordType&)>...> key_extractors_; 
 
@@ -201,6 +286,15 @@ class CompositeIndex {
     CompositeIndex(std::function<Keys(const RecordType&)>... extractors)
         : key_extractors_(extractors...) {}
 
+    /**
+     * @brief Constructs a CompositeIndex whose records and tree nodes live in a memory resource.
+     *
+     * @param resource Must outlive the index.
+     * @param extractors Functions to extract individual keys from records.
+     */
+    CompositeIndex(std::pmr::memory_resource* resource, std::function<Keys(const RecordType&)>... extractors)
+        : tree_(resource), records_(resource), key_extractors_(extractors...) {}
+
     /**
      * @brief Inserts a record into the composite index.
      *
@@ -212,6 +306,36 @@ class CompositeIndex {
         tree_.insert(key, record.get_id());
     }
 
+    /**
+     * @brief Populates an empty composite index from a range of records in one pass.
+     *
+     * @param first, last The records, in any order.
+     * @param fill_factor Share of each tree node to fill (see BPlusTree::bulk_load).
+     *
+     * @throws std::logic_error if the index already holds records.
+     * @throws std::invalid_argument if the tree rejects the load; the index stays empty.
+     */
+    template<typename InputIt>
+    void bulk_load(InputIt first, InputIt last, double fill_factor = 1.0) {
+        if (records_.size() != 0) {
+            throw std::logic_error("bulk_load requires an empty index");
+        }
+
+        std::vector<std::pair<CompositeKey<Keys...>, size_t>> entries;
+        // The records are only kept once the tree has accepted them
+        std::pmr::vector<RecordType> loaded(records_.get_allocator());
+        for (; first != last; ++first) {
+            loaded.push_back(*first);
+            entries.emplace_back(make_key(*first, std::index_sequence_for<Keys...>{}), first->get_id());
+        }
+
+        std::stable_sort(entries.begin(), entries.end(), [](const auto& a, const auto& b) {
+            return a.first < b.first;
+        });
+        tree_.bulk_load(entries.begin(), entries.end(), fill_factor);
+        records_.swap(loaded);
+    }
+
     /**
      * @brief Finds all records with the given composite key.
      *
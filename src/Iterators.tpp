@@ -4,30 +4,108 @@
 
 // ---------------- ITERATOR METHODS IMPLEMENTATION ----------------
 
-template <typename Key, typename RecordId, size_t Order, typename compare>
-BPlusTree<Key, RecordId, Order, compare>::Iterator::Iterator(LeafNodePtr node, size_t index)
-    : current_node_(node), current_index_(index) {}
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::Iterator::Iterator(LeafNodeRef node, size_t index, const BPlusTree* tree)
+    : current_node_(node), current_index_(index), tree_(tree) {}
 
 
-template <typename Key, typename RecordId, size_t Order, typename compare>
-typename BPlusTree<Key, RecordId, Order, compare>::Iterator& 
-BPlusTree<Key, RecordId, Order, compare>::Iterator::operator++() {
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+typename BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::Iterator& 
+BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::Iterator::operator++() {
     if (!current_node_) {
         return *this;
     }
 
     current_index_++;
-    if (current_index_ >= current_node_->keys_.size()) {
-        current_node_ = current_node_->next_;
+
+    // Skip to the next leaf that has entries; B-link trees may contain empty leaves
+    while (current_node_ && current_index_ >= current_node_->keys_.size()) {
+        current_node_ = current_node_->next_.get();
         current_index_ = 0;
     }
 
     return *this;
 }
 
-template <typename Key, typename RecordId, size_t Order, typename compare>
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+typename BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::Iterator& 
+BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::Iterator::operator--() {
+    // Stepping back from end() resumes at the last leaf
+    if (!current_node_ && tree_) {
+        EpochGuard guard;
+        current_node_ = tree_->rightmost_leaf();
+        if (current_node_) {
+            current_node_->mutex_.unlock_shared();
+            current_index_ = current_node_->keys_.size();
+        }
+    }
+
+    while (current_node_ && current_index_ == 0) {
+        current_node_ = current_node_->prev_.load(std::memory_order_acquire);
+        current_index_ = current_node_ ? current_node_->keys_.size() : 0;
+    }
+
+    if (current_node_) {
+        current_index_--;
+    }
+    return *this;
+}
+
+/**
+ * @brief Moves forward to the first entry whose key is not less than key
+ * 
+ * @details
+ * The walk continues from the current leaf instead of descending from the root:
+ * leaves whose last key is still below the target are stepped over, and the
+ * position within the leaf that holds it is found by binary search. An iterator
+ * already at or past the key does not move. Like operator++, it takes no latches.
+ */
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+typename BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::Iterator& 
+BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::Iterator::seek(const Key& key) {
+    if (!tree_) {
+        return *this;
+    }
+    const compare& comp = tree_->comparator_;
+
+    while (current_node_) {
+        const auto& keys = current_node_->keys_;
+        if (current_index_ < keys.size() && !comp(keys.back(), key)) {
+            current_index_ = tree_->leaf_lower_bound(*current_node_, current_index_, keys.size(), key);
+            return *this;
+        }
+        current_node_ = current_node_->next_.get();
+        current_index_ = 0;
+    }
+    return *this;
+}
+
+/**
+ * @brief Moves forward to the first entry whose key is greater than key
+ */
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+void BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::Iterator::seek_past(const Key& key) {
+    if (!tree_) {
+        return;
+    }
+    const compare& comp = tree_->comparator_;
+
+    while (current_node_) {
+        const auto& keys = current_node_->keys_;
+        if (current_index_ < keys.size() && comp(key, keys.back())) {
+            current_index_ = std::upper_bound(keys.begin() + current_index_, keys.end(), key, comp) - keys.begin();
+            return;
+        }
+        current_node_ = current_node_->next_.get();
+        current_index_ = 0;
+    }
+}
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
 Pair<const Key&, RecordId&> 
-BPlusTree<Key, RecordId, Order, compare>::Iterator::operator*() const {
+BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::Iterator::operator*() const {
     if (!current_node_ || current_index_ >= current_node_->keys_.size()) {
         throw std::out_of_range("Iterator is out of range");
     }
@@ -35,38 +113,65 @@ BPlusTree<Key, RecordId, Order, compare>::Iterator::operator*() const {
             current_node_->values_[current_index_]};
 }
 
-template <typename Key, typename RecordId, size_t Order, typename compare>
-bool BPlusTree<Key, RecordId, Order, compare>::Iterator::operator==(const Iterator& other) const {
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+bool BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::Iterator::operator==(const Iterator& other) const {
     return current_node_ == other.current_node_ && current_index_ == other.current_index_;
 }
 
-template <typename Key, typename RecordId, size_t Order, typename compare>
-bool BPlusTree<Key, RecordId, Order, compare>::Iterator::operator!=(const Iterator& other) const {
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+bool BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::Iterator::operator!=(const Iterator& other) const {
     return !(*this == other);
 }
 
 // ---------------- CONST ITERATOR METHODS IMPLEMENTATION ----------------
 
-template <typename Key, typename RecordId, size_t Order, typename compare>
-typename BPlusTree<Key, RecordId, Order, compare>::ConstIterator& 
-BPlusTree<Key, RecordId, Order, compare>::ConstIterator::operator++() {
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::ConstIterator::ConstIterator(LeafNodeRef node, size_t index, const BPlusTree* tree)
+    : current_node_(node), current_index_(index), tree_(tree) {}
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+typename BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::ConstIterator& 
+BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::ConstIterator::operator++() {
     if (!current_node_) {
         return *this;
     }
 
     current_index_++;
     
-    if (current_index_ >= current_node_->size()) {
-        current_node_ = current_node_->next_;
+    while (current_node_ && current_index_ >= current_node_->size()) {
+        current_node_ = current_node_->next_.get();
         current_index_ = 0;
     }
     
     return *this;
 }
 
-template <typename Key, typename RecordId, size_t Order, typename compare>
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+typename BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::ConstIterator& 
+BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::ConstIterator::operator--() {
+    if (!current_node_ && tree_) {
+        EpochGuard guard;
+        current_node_ = tree_->rightmost_leaf();
+        if (current_node_) {
+            current_node_->mutex_.unlock_shared();
+            current_index_ = current_node_->size();
+        }
+    }
+
+    while (current_node_ && current_index_ == 0) {
+        current_node_ = current_node_->prev_.load(std::memory_order_acquire);
+        current_index_ = current_node_ ? current_node_->size() : 0;
+    }
+
+    if (current_node_) {
+        current_index_--;
+    }
+    return *this;
+}
+
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
 const Pair<const Key&, const RecordId&> 
-BPlusTree<Key, RecordId, Order, compare>::ConstIterator::operator*() const {
+BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::ConstIterator::operator*() const {
     if (!current_node_ || current_index_ >= current_node_->size()) {
         throw std::runtime_error("Invalid iterator dereference");
     }
@@ -77,39 +182,39 @@ BPlusTree<Key, RecordId, Order, compare>::ConstIterator::operator*() const {
     );
 }
 
-template <typename Key, typename RecordId, size_t Order, typename compare>
-bool BPlusTree<Key, RecordId, Order, compare>::ConstIterator::operator==(const ConstIterator& other) const {
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+bool BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::ConstIterator::operator==(const ConstIterator& other) const {
     return current_node_ == other.current_node_ && current_index_ == other.current_index_;
 }
 
-template <typename Key, typename RecordId, size_t Order, typename compare>
-bool BPlusTree<Key, RecordId, Order, compare>::ConstIterator::operator!=(const ConstIterator& other) const {
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+bool BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::ConstIterator::operator!=(const ConstIterator& other) const {
     return !(*this == other);
 }
 
 
 // ---------------- FILTER ITERATOR IMPLEMENTATION ----------------
 
-template <typename Key, typename RecordId, size_t Order, typename compare>
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
 template <typename Predicate>
-void BPlusTree<Key, RecordId, Order, compare>::FilterIterator<Predicate>::find_next_valid() {
+void BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::FilterIterator<Predicate>::find_next_valid() {
     while (current_ != end_ && !pred_(*current_)) {
         ++current_;
     }
 }
 
-template <typename Key, typename RecordId, size_t Order, typename compare>
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
 template <typename Predicate>
-BPlusTree<Key, RecordId, Order, compare>::FilterIterator<Predicate>::FilterIterator(
+BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::FilterIterator<Predicate>::FilterIterator(
     Iterator begin, Iterator end, Predicate pred)
     : current_(begin), end_(end), pred_(pred) {
     find_next_valid();
 }
 
-template <typename Key, typename RecordId, size_t Order, typename compare>
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
 template <typename Predicate>
-typename BPlusTree<Key, RecordId, Order, compare>::template FilterIterator<Predicate>& 
-BPlusTree<Key, RecordId, Order, compare>::FilterIterator<Predicate>::operator++() {
+typename BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::template FilterIterator<Predicate>& 
+BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::FilterIterator<Predicate>::operator++() {
     if (current_ != end_) {
         ++current_;
         find_next_valid();
@@ -117,75 +222,75 @@ BPlusTree<Key, RecordId, Order, compare>::FilterIterator<Predicate>::operator++(
     return *this;
 }
 
-template <typename Key, typename RecordId, size_t Order, typename compare>
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
 template <typename Predicate>
-auto BPlusTree<Key, RecordId, Order, compare>::FilterIterator<Predicate>::operator*() {
+auto BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::FilterIterator<Predicate>::operator*() {
     return *current_;
 }
 
-template <typename Key, typename RecordId, size_t Order, typename compare>
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
 template <typename Predicate>
-bool BPlusTree<Key, RecordId, Order, compare>::FilterIterator<Predicate>::operator==(
+bool BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::FilterIterator<Predicate>::operator==(
     const FilterIterator& other) const {
     return current_ == other.current_;
 }
 
-template <typename Key, typename RecordId, size_t Order, typename compare>
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
 template <typename Predicate>
-bool BPlusTree<Key, RecordId, Order, compare>::FilterIterator<Predicate>::operator!=(
+bool BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::FilterIterator<Predicate>::operator!=(
     const FilterIterator& other) const {
     return !(*this == other);
 }
 
 // TreeRange implementation
-template <typename Key, typename RecordId, size_t Order, typename compare>
-typename BPlusTree<Key, RecordId, Order, compare>::Iterator 
-BPlusTree<Key, RecordId, Order, compare>::TreeRange::begin() {
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+typename BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::Iterator 
+BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::TreeRange::begin() {
     return tree_.begin();
 }
 
-template <typename Key, typename RecordId, size_t Order, typename compare>
-typename BPlusTree<Key, RecordId, Order, compare>::Iterator 
-BPlusTree<Key, RecordId, Order, compare>::TreeRange::end() {
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+typename BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::Iterator 
+BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::TreeRange::end() {
     return tree_.end();
 }
 
 // FilterRange implementation
-template <typename Key, typename RecordId, size_t Order, typename compare>
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
 template <typename Predicate>
-BPlusTree<Key, RecordId, Order, compare>::FilterRange<Predicate>::FilterRange(
+BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::FilterRange<Predicate>::FilterRange(
     BPlusTree& tree, Predicate pred)
     : tree_(tree), pred_(pred) {}
 
-template <typename Key, typename RecordId, size_t Order, typename compare>
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
 template <typename Predicate>
-typename BPlusTree<Key, RecordId, Order, compare>::template FilterIterator<Predicate>
-BPlusTree<Key, RecordId, Order, compare>::FilterRange<Predicate>::begin() {
+typename BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::template FilterIterator<Predicate>
+BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::FilterRange<Predicate>::begin() {
     return FilterIterator<Predicate>(tree_.begin(), tree_.end(), pred_);
 }
 
-template <typename Key, typename RecordId, size_t Order, typename compare>
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
 template <typename Predicate>
-typename BPlusTree<Key, RecordId, Order, compare>::template FilterIterator<Predicate>
-BPlusTree<Key, RecordId, Order, compare>::FilterRange<Predicate>::end() {
+typename BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::template FilterIterator<Predicate>
+BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::FilterRange<Predicate>::end() {
     return FilterIterator<Predicate>(tree_.end(), tree_.end(), pred_);
 }
 
 // Range-based for support methods
-template <typename Key, typename RecordId, size_t Order, typename compare>
-typename BPlusTree<Key, RecordId, Order, compare>::TreeRange 
-BPlusTree<Key, RecordId, Order, compare>::range() {
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+typename BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::TreeRange 
+BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::range() {
     return TreeRange(*this);
 }
 
-template <typename Key, typename RecordId, size_t Order, typename compare>
-BPlusTree<Key, RecordId, Order, compare>::operator TreeRange() {
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
+BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::operator TreeRange() {
     return range();
 }
 
-template <typename Key, typename RecordId, size_t Order, typename compare>
+template <typename Key, typename RecordId, size_t Order, typename compare, size_t InternalOrder, typename NodeAllocator>
 template <typename Predicate>
-typename BPlusTree<Key, RecordId, Order, compare>::template FilterRange<Predicate>
-BPlusTree<Key, RecordId, Order, compare>::filter(Predicate pred) {
+typename BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::template FilterRange<Predicate>
+BPlusTree<Key, RecordId, Order, compare, InternalOrder, NodeAllocator>::filter(Predicate pred) {
     return FilterRange<Predicate>(*this, pred);
 }
@@ -0,0 +1,140 @@
+#pragma once
+
+#include "Composite-Key.hpp"
+#include "Prefixed-Keys.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+
+/**
+ * @brief Encodes values as byte strings that sort like the values themselves
+ *
+ * @details
+ * encode() appends the bytes of a value to out. For any a and b of the same type,
+ * a < b exactly when encode(a) < encode(b) byte by byte (unsigned, as memcmp and
+ * std::string compare), and equal values get equal bytes. decode() reads one value
+ * back from the front of in and advances in past it.
+ *
+ * - Unsigned integers and bool: big-endian.
+ * - Signed integers: the sign bit flipped, then big-endian.
+ * - float and double: the sign bit flipped for positive values, every bit flipped for
+ *   negative ones, then big-endian; -0.0 is stored as 0.0. NaNs are not ordered.
+ * - std::string: 0x00 bytes escaped as 0x00 0xFF and the end marked with 0x00 0x00,
+ *   so a string sorts before every longer string it is a prefix of, and the next
+ *   component of a composite key starts at a known place.
+ *
+ * Specialize for further types with the same two members.
+ */
+
+template <typename T, typename = void>
+struct KeyNormalizer;
+
+template <typename T>
+struct KeyNormalizer<T, std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>>> {
+    static void encode(std::string& out, T value);
+    static T decode(std::string_view& in);
+};
+
+template <typename T>
+struct KeyNormalizer<T, std::enable_if_t<std::is_floating_point_v<T>>> {
+    static_assert(sizeof(T) == 4 || sizeof(T) == 8, "only 32- and 64-bit floating point keys");
+
+    static void encode(std::string& out, T value);
+    static T decode(std::string_view& in);
+};
+
+template <>
+struct KeyNormalizer<bool> {
+    static void encode(std::string& out, bool value);
+    static bool decode(std::string_view& in);
+};
+
+template <>
+struct KeyNormalizer<std::string> {
+    static void encode(std::string& out, const std::string& value);
+    static std::string decode(std::string_view& in);
+};
+
+template <typename... Keys>
+struct KeyNormalizer<CompositeKey<Keys...>> {
+    static void encode(std::string& out, const CompositeKey<Keys...>& value);
+    static CompositeKey<Keys...> decode(std::string_view& in);
+};
+
+
+/**
+ * @brief The order-preserving byte string of a key (see KeyNormalizer)
+ */
+
+template <typename Key>
+std::string normalize_key(const Key& key);
+
+
+/**
+ * @brief The key whose normalized form is bytes
+ */
+
+template <typename Key>
+Key denormalize_key(std::string_view bytes);
+
+
+
+/**
+ * @brief A normalized key stored inline in a fixed number of bytes
+ *
+ * @details
+ * Trivially copyable, so a node holds its keys without pointing anywhere else and
+ * optimistic readers may copy them. The bytes past size() are zero, which lets
+ * operator< compare the whole buffer a word at a time, with no length checks on the
+ * way, and break ties by length: a key sorts before its extensions exactly as in a
+ * byte string.
+ *
+ * @tparam Capacity Longest encoding that fits; longer ones are rejected
+ */
+
+template <size_t Capacity>
+class NormalizedKey {
+  private:
+
+    // Rounded up to whole words, which operator< compares one at a time
+    static constexpr size_t words = (Capacity + 7) / 8;
+
+    std::array<unsigned char, words * 8> bytes_{};
+    size_t size_ = 0;
+
+  public:
+
+    NormalizedKey() = default;
+
+    /**
+     * @throws std::length_error if bytes is longer than Capacity
+     */
+    explicit NormalizedKey(std::string_view bytes);
+
+    static constexpr size_t capacity() noexcept { return Capacity; }
+
+    size_t size() const noexcept { return size_; }
+    const unsigned char* data() const noexcept { return bytes_.data(); }
+    std::string_view view() const noexcept { return {reinterpret_cast<const char*>(bytes_.data()), size_}; }
+
+    // Bytes [8 * index, 8 * index + 8) as a big-endian number
+    uint64_t word(size_t index) const noexcept;
+
+    bool operator<(const NormalizedKey& other) const noexcept;
+    bool operator==(const NormalizedKey& other) const noexcept;
+};
+
+
+// The first eight bytes, zero-padded like the key itself
+template <size_t Capacity>
+struct KeyPrefix<NormalizedKey<Capacity>> {
+    static constexpr bool enabled = true;
+
+    static uint64_t of(const NormalizedKey<Capacity>& key) noexcept;
+};
+
+#include "Key-Normalizer.tpp"
@@ -0,0 +1,190 @@
+#include "Key-Normalizer.hpp"
+#include <bit>
+#include <cstring>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+// ------------------------- KEY NORMALIZER IMPLEMENTATION --------------------------
+
+
+namespace key_normalizer_detail {
+
+template <typename Unsigned>
+void append_big_endian(std::string& out, Unsigned bits) {
+    for (size_t shift = sizeof(Unsigned) * 8; shift > 0; shift -= 8) {
+        out.push_back(static_cast<char>(static_cast<unsigned char>(bits >> (shift - 8))));
+    }
+}
+
+template <typename Unsigned>
+Unsigned read_big_endian(std::string_view& in) {
+    Unsigned bits = 0;
+    for (size_t i = 0; i < sizeof(Unsigned); ++i) {
+        bits = static_cast<Unsigned>((bits << 8) | static_cast<unsigned char>(in[i]));
+    }
+    in.remove_prefix(sizeof(Unsigned));
+    return bits;
+}
+
+} // namespace key_normalizer_detail
+
+
+template <typename T>
+void KeyNormalizer<T, std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>>>::encode(std::string& out, T value) {
+    using Unsigned = std::make_unsigned_t<T>;
+    Unsigned bits = static_cast<Unsigned>(value);
+    if constexpr (std::is_signed_v<T>) {
+        bits ^= Unsigned(1) << (sizeof(T) * 8 - 1);
+    }
+    key_normalizer_detail::append_big_endian(out, bits);
+}
+
+template <typename T>
+T KeyNormalizer<T, std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>>>::decode(std::string_view& in) {
+    using Unsigned = std::make_unsigned_t<T>;
+    Unsigned bits = key_normalizer_detail::read_big_endian<Unsigned>(in);
+    if constexpr (std::is_signed_v<T>) {
+        bits ^= Unsigned(1) << (sizeof(T) * 8 - 1);
+    }
+    return static_cast<T>(bits);
+}
+
+
+template <typename T>
+void KeyNormalizer<T, std::enable_if_t<std::is_floating_point_v<T>>>::encode(std::string& out, T value) {
+    using Bits = std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>;
+    constexpr Bits sign = Bits(1) << (sizeof(T) * 8 - 1);
+
+    Bits bits = std::bit_cast<Bits>(value == T(0) ? T(0) : value);
+    bits = (bits & sign) ? ~bits : bits ^ sign;
+    key_normalizer_detail::append_big_endian(out, bits);
+}
+
+template <typename T>
+T KeyNormalizer<T, std::enable_if_t<std::is_floating_point_v<T>>>::decode(std::string_view& in) {
+    using Bits = std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>;
+    constexpr Bits sign = Bits(1) << (sizeof(T) * 8 - 1);
+
+    Bits bits = key_normalizer_detail::read_big_endian<Bits>(in);
+    bits = (bits & sign) ? bits ^ sign : ~bits;
+    return std::bit_cast<T>(bits);
+}
+
+
+inline void KeyNormalizer<bool>::encode(std::string& out, bool value) {
+    out.push_back(value ? '\1' : '\0');
+}
+
+inline bool KeyNormalizer<bool>::decode(std::string_view& in) {
+    bool value = in[0] != '\0';
+    in.remove_prefix(1);
+    return value;
+}
+
+
+inline void KeyNormalizer<std::string>::encode(std::string& out, const std::string& value) {
+    for (char c : value) {
+        out.push_back(c);
+        if (c == '\0') {
+            out.push_back('\xFF');
+        }
+    }
+    out.push_back('\0');
+    out.push_back('\0');
+}
+
+inline std::string KeyNormalizer<std::string>::decode(std::string_view& in) {
+    std::string value;
+    size_t i = 0;
+    for (; in[i] != '\0' || in[i + 1] != '\0'; ++i) {
+        value.push_back(in[i]);
+        if (in[i] == '\0') {
+            ++i;  // skip the escape byte
+        }
+    }
+    in.remove_prefix(i + 2);
+    return value;
+}
+
+
+// Components are encoded one after the other; each encoding is self-delimiting, so the
+// first component that differs decides the order
+template <typename... Keys>
+void KeyNormalizer<CompositeKey<Keys...>>::encode(std::string& out, const CompositeKey<Keys...>& value) {
+    std::apply([&out](const auto&... components) {
+        (KeyNormalizer<std::decay_t<decltype(components)>>::encode(out, components), ...);
+    }, value.parameters_);
+}
+
+template <typename... Keys>
+CompositeKey<Keys...> KeyNormalizer<CompositeKey<Keys...>>::decode(std::string_view& in) {
+    CompositeKey<Keys...> value;
+    std::apply([&in](auto&... components) {
+        ((components = KeyNormalizer<std::decay_t<decltype(components)>>::decode(in)), ...);
+    }, value.parameters_);
+    return value;
+}
+
+
+template <typename Key>
+std::string normalize_key(const Key& key) {
+    std::string bytes;
+    KeyNormalizer<Key>::encode(bytes, key);
+    return bytes;
+}
+
+template <typename Key>
+Key denormalize_key(std::string_view bytes) {
+    return KeyNormalizer<Key>::decode(bytes);
+}
+
+
+template <size_t Capacity>
+NormalizedKey<Capacity>::NormalizedKey(std::string_view bytes) : size_(bytes.size()) {
+    if (bytes.size() > Capacity) {
+        throw std::length_error("normalized key does not fit in NormalizedKey");
+    }
+    std::memcpy(bytes_.data(), bytes.data(), bytes.size());
+}
+
+template <size_t Capacity>
+uint64_t NormalizedKey<Capacity>::word(size_t index) const noexcept {
+    uint64_t value;
+    std::memcpy(&value, bytes_.data() + index * 8, 8);
+    if constexpr (std::endian::native == std::endian::little) {
+#if defined(__GNUC__)
+        value = __builtin_bswap64(value);
+#else
+        uint64_t swapped = 0;
+        for (int i = 0; i < 8; ++i) {
+            swapped = (swapped << 8) | ((value >> (8 * i)) & 0xFF);
+        }
+        value = swapped;
+#endif
+    }
+    return value;
+}
+
+template <size_t Capacity>
+bool NormalizedKey<Capacity>::operator<(const NormalizedKey& other) const noexcept {
+    for (size_t i = 0; i < words; ++i) {
+        uint64_t mine = word(i);
+        uint64_t theirs = other.word(i);
+        if (mine != theirs) {
+            return mine < theirs;
+        }
+    }
+    return size_ < other.size_;
+}
+
+template <size_t Capacity>
+bool NormalizedKey<Capacity>::operator==(const NormalizedKey& other) const noexcept {
+    return size_ == other.size_ && std::memcmp(bytes_.data(), other.bytes_.data(), bytes_.size()) == 0;
+}
+
+
+template <size_t Capacity>
+uint64_t KeyPrefix<NormalizedKey<Capacity>>::of(const NormalizedKey<Capacity>& key) noexcept {
+    return key.word(0);
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+
+
+/**
+ * @brief Whether the vectorized search kernel can stand in for std::lower_bound
+ *
+ * @details
+ * True for 32- and 64-bit integers, float and double ordered by std::less. For
+ * those, "number of keys below the search key" is the lower_bound position and
+ * can be computed with plain SIMD compares.
+ */
+
+template <typename Key, typename Compare>
+inline constexpr bool simd_searchable =
+    (std::is_same_v<Compare, std::less<Key>> || std::is_same_v<Compare, std::less<>>) &&
+    ((std::is_integral_v<Key> && !std::is_same_v<Key, bool> && (sizeof(Key) == 4 || sizeof(Key) == 8)) ||
+     std::is_same_v<Key, float> || std::is_same_v<Key, double>);
+
+
+/**
+ * @brief Counts the keys in [keys, keys + count) that are smaller than key
+ *
+ * @details
+ * Uses AVX2 when the translation unit is compiled for it, SSE otherwise, and a
+ * branch-free scalar loop for the remainder and for targets without SIMD.
+ */
+
+template <typename Key>
+size_t count_less(const Key* keys, size_t count, Key key);
+
+
+/**
+ * @brief Drop-in replacement for std::lower_bound over a node's key array
+ *
+ * @details
+ * For simd_searchable keys, binary search narrows the range to a window of a few
+ * cache lines, which is then finished with count_less(). Other key types and
+ * comparators fall back to std::lower_bound.
+ */
+
+template <typename Key, typename Compare>
+const Key* key_lower_bound(const Key* first, const Key* last, const Key& key, const Compare& comp);
+
+template <typename Key, typename Compare>
+Key* key_lower_bound(Key* first, Key* last, const Key& key, const Compare& comp);
+
+#include "Key-Search.tpp"
@@ -0,0 +1,132 @@
+#include "Key-Search.hpp"
+#include <algorithm>
+#include <bit>
+#include <climits>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+// ------------------------- KEY SEARCH IMPLEMENTATION --------------------------
+
+
+// Binary search stops once the candidate range fits in this many bytes; comparing
+// the rest in full is cheaper than the mispredicted branches it would take.
+// Measured with benchmarks/search_benchmark.cpp on 128-key nodes.
+#if defined(__AVX2__)
+inline constexpr size_t key_search_window_bytes = 256;
+#else
+inline constexpr size_t key_search_window_bytes = 64;
+#endif
+
+template <typename Key>
+inline constexpr size_t key_search_window = key_search_window_bytes / sizeof(Key);
+
+
+template <typename Key>
+size_t count_less(const Key* keys, size_t count, Key key) {
+
+    size_t result = 0;
+    size_t i = 0;
+
+#if defined(__AVX2__)
+    if constexpr (std::is_same_v<Key, float>) {
+        __m256 needle = _mm256_set1_ps(key);
+        for (; i + 8 <= count; i += 8) {
+            __m256 less = _mm256_cmp_ps(_mm256_loadu_ps(keys + i), needle, _CMP_LT_OQ);
+            result += std::popcount(static_cast<unsigned>(_mm256_movemask_ps(less)));
+        }
+    } else if constexpr (std::is_same_v<Key, double>) {
+        __m256d needle = _mm256_set1_pd(key);
+        for (; i + 4 <= count; i += 4) {
+            __m256d less = _mm256_cmp_pd(_mm256_loadu_pd(keys + i), needle, _CMP_LT_OQ);
+            result += std::popcount(static_cast<unsigned>(_mm256_movemask_pd(less)));
+        }
+    } else if constexpr (sizeof(Key) == 4) {
+        // Unsigned keys are compared as signed after flipping the sign bit
+        __m256i flip = _mm256_set1_epi32(std::is_signed_v<Key> ? 0 : INT32_MIN);
+        __m256i needle = _mm256_xor_si256(_mm256_set1_epi32(static_cast<int32_t>(key)), flip);
+        for (; i + 8 <= count; i += 8) {
+            __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + i));
+            __m256i less = _mm256_cmpgt_epi32(needle, _mm256_xor_si256(block, flip));
+            result += std::popcount(static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(less))));
+        }
+    } else {
+        __m256i flip = _mm256_set1_epi64x(std::is_signed_v<Key> ? 0 : INT64_MIN);
+        __m256i needle = _mm256_xor_si256(_mm256_set1_epi64x(static_cast<int64_t>(key)), flip);
+        for (; i + 4 <= count; i += 4) {
+            __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + i));
+            __m256i less = _mm256_cmpgt_epi64(needle, _mm256_xor_si256(block, flip));
+            result += std::popcount(static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(less))));
+        }
+    }
+#elif defined(__SSE2__)
+    if constexpr (std::is_same_v<Key, float>) {
+        __m128 needle = _mm_set1_ps(key);
+        for (; i + 4 <= count; i += 4) {
+            __m128 less = _mm_cmplt_ps(_mm_loadu_ps(keys + i), needle);
+            result += std::popcount(static_cast<unsigned>(_mm_movemask_ps(less)));
+        }
+    } else if constexpr (std::is_same_v<Key, double>) {
+        __m128d needle = _mm_set1_pd(key);
+        for (; i + 2 <= count; i += 2) {
+            __m128d less = _mm_cmplt_pd(_mm_loadu_pd(keys + i), needle);
+            result += std::popcount(static_cast<unsigned>(_mm_movemask_pd(less)));
+        }
+    } else if constexpr (sizeof(Key) == 4) {
+        __m128i flip = _mm_set1_epi32(std::is_signed_v<Key> ? 0 : INT32_MIN);
+        __m128i needle = _mm_xor_si128(_mm_set1_epi32(static_cast<int32_t>(key)), flip);
+        for (; i + 4 <= count; i += 4) {
+            __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + i));
+            __m128i less = _mm_cmplt_epi32(_mm_xor_si128(block, flip), needle);
+            result += std::popcount(static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(less))));
+        }
+    } else {
+#if defined(__SSE4_2__)
+        __m128i flip = _mm_set1_epi64x(std::is_signed_v<Key> ? 0 : INT64_MIN);
+        __m128i needle = _mm_xor_si128(_mm_set1_epi64x(static_cast<int64_t>(key)), flip);
+        for (; i + 2 <= count; i += 2) {
+            __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + i));
+            __m128i less = _mm_cmpgt_epi64(needle, _mm_xor_si128(block, flip));
+            result += std::popcount(static_cast<unsigned>(_mm_movemask_pd(_mm_castsi128_pd(less))));
+        }
+#endif
+    }
+#endif
+
+    // Tail, and the whole range on targets without SIMD
+    for (; i < count; ++i) {
+        result += keys[i] < key;
+    }
+    return result;
+}
+
+
+template <typename Key, typename Compare>
+const Key* key_lower_bound(const Key* first, const Key* last, const Key& key, const Compare& comp) {
+
+    if constexpr (simd_searchable<Key, Compare>) {
+        size_t count = static_cast<size_t>(last - first);
+
+        while (count > key_search_window<Key>) {
+            size_t half = count / 2;
+            if (first[half] < key) {
+                first += half + 1;
+                count -= half + 1;
+            } else {
+                count = half;
+            }
+        }
+        return first + count_less(first, count, key);
+
+    } else {
+        return std::lower_bound(first, last, key, comp);
+    }
+}
+
+
+template <typename Key, typename Compare>
+Key* key_lower_bound(Key* first, Key* last, const Key& key, const Compare& comp) {
+    return const_cast<Key*>(key_lower_bound(static_cast<const Key*>(first),
+                                            static_cast<const Key*>(last), key, comp));
+}
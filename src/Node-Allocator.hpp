@@ -0,0 +1,312 @@
+#pragma once
+
+#include "Node-Pointer.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+
+
+/**
+ * @brief Class-specific allocation for tree nodes
+ *
+ * @details
+ * `new (resource) Node()` places a node in memory obtained from a memory resource and
+ * records the resource and the size in a header in front of it. The plain delete that
+ * NodePtr issues reads the header and gives the memory back where it came from, so
+ * owners of a node never need to know how it was allocated. A plain `new Node()` takes
+ * its memory from the global heap.
+ */
+
+struct ResourceAllocated {
+  private:
+
+    struct alignas(std::max_align_t) Header {
+        std::pmr::memory_resource* resource;  // nullptr for the global heap
+        size_t bytes;
+    };
+
+  public:
+
+    // Bytes taken from a resource for an object of the given size
+    static constexpr size_t allocation_size(size_t size) noexcept {
+        return sizeof(Header) + size;
+    }
+
+    static void* operator new(size_t size, std::pmr::memory_resource* resource) {
+        const size_t bytes = allocation_size(size);
+        void* memory = resource ? resource->allocate(bytes, alignof(Header)) : ::operator new(bytes);
+        return ::new (memory) Header{resource, bytes} + 1;
+    }
+
+    static void* operator new(size_t size) {
+        return operator new(size, nullptr);
+    }
+
+    static void operator delete(void* object) noexcept {
+        Header* header = static_cast<Header*>(object) - 1;
+        if (header->resource) {
+            header->resource->deallocate(header, header->bytes, alignof(Header));
+        } else {
+            ::operator delete(header);
+        }
+    }
+
+    // Called when the constructor of a node placed with a resource throws
+    static void operator delete(void* object, std::pmr::memory_resource*) noexcept {
+        operator delete(object);
+    }
+};
+
+
+
+/**
+ * @brief Fixed-size slot allocator carved out of large slabs
+ *
+ * @details
+ * Every allocation is one slot. Freed slots go on a free list and are handed out
+ * again first, so the nodes of a tree stay packed into a few slabs however much they
+ * churn. Slabs come from an upstream resource, start small and double in size up to
+ * about a megabyte, and are only given back all at once when the pool is destroyed.
+ *
+ * A pool is shared by its owner and by everything allocated from it. The owner lets
+ * go with orphan(); the pool then frees itself as soon as its last slot is returned,
+ * which may be much later for nodes that are retired or moved into another tree.
+ */
+
+class NodePool : public std::pmr::memory_resource {
+  private:
+
+    struct FreeSlot {
+        FreeSlot* next;
+    };
+
+    struct alignas(std::max_align_t) Slab {
+        Slab* next;
+        size_t bytes;
+    };
+
+    static constexpr size_t first_slab_slots = 4;
+    static constexpr size_t max_slab_bytes = size_t(1) << 20;
+
+    const size_t slot_bytes_;
+    std::pmr::memory_resource* upstream_;
+
+    std::mutex mutex_;
+    FreeSlot* free_ = nullptr;
+    Slab* slabs_ = nullptr;
+    size_t next_slab_slots_ = first_slab_slots;
+    size_t live_ = 0;
+    bool orphaned_ = false;
+
+    ~NodePool() override {
+        while (slabs_) {
+            Slab* slab = slabs_;
+            slabs_ = slab->next;
+            upstream_->deallocate(slab, slab->bytes, alignof(Slab));
+        }
+    }
+
+    // Threads every slot of a new slab onto the free list; the caller holds mutex_
+    void grow() {
+        const size_t slots = next_slab_slots_;
+        const size_t bytes = sizeof(Slab) + slots * slot_bytes_;
+        Slab* slab = ::new (upstream_->allocate(bytes, alignof(Slab))) Slab{slabs_, bytes};
+        slabs_ = slab;
+
+        std::byte* first = reinterpret_cast<std::byte*>(slab + 1);
+        for (size_t i = slots; i-- > 0;) {
+            free_ = ::new (first + i * slot_bytes_) FreeSlot{free_};
+        }
+
+        if ((2 * slots) * slot_bytes_ <= max_slab_bytes) {
+            next_slab_slots_ = 2 * slots;
+        }
+    }
+
+  protected:
+
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        if (bytes > slot_bytes_ || alignment > alignof(std::max_align_t)) {
+            throw std::bad_alloc();
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!free_) {
+            grow();
+        }
+        FreeSlot* slot = free_;
+        free_ = slot->next;
+        ++live_;
+        return slot;
+    }
+
+    void do_deallocate(void* pointer, size_t, size_t) override {
+        std::unique_lock<std::mutex> lock(mutex_);
+        free_ = ::new (pointer) FreeSlot{free_};
+        if (--live_ == 0 && orphaned_) {
+            lock.unlock();
+            delete this;
+        }
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+  public:
+
+    /**
+     * @param slot_bytes Size of every allocation the pool serves
+     * @param upstream Where the slabs come from
+     */
+    NodePool(size_t slot_bytes, std::pmr::memory_resource* upstream)
+        : slot_bytes_((std::max(slot_bytes, sizeof(FreeSlot)) + alignof(std::max_align_t) - 1) /
+                      alignof(std::max_align_t) * alignof(std::max_align_t)),
+          upstream_(upstream) {}
+
+    NodePool(const NodePool&) = delete;
+    NodePool& operator=(const NodePool&) = delete;
+
+    size_t slot_bytes() const noexcept { return slot_bytes_; }
+
+    /**
+     * @brief Releases the owner's hold on the pool
+     *
+     * @details
+     * The pool is destroyed right away if no slot is in use, and otherwise when the
+     * last one is returned. The owner must not allocate from the pool afterwards.
+     */
+    void orphan() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        orphaned_ = true;
+        if (live_ == 0) {
+            lock.unlock();
+            delete this;
+        }
+    }
+};
+
+
+
+/**
+ * @brief Node allocation policy that gives every node an allocation of its own
+ *
+ * @details
+ * The default. Without a memory resource every node comes from the global heap; with
+ * one, the node is allocated from the resource, which has to be thread-safe if the
+ * tree is shared between threads.
+ */
+
+class HeapNodeAllocator {
+  private:
+
+    std::pmr::memory_resource* resource_ = nullptr;
+
+  public:
+
+    HeapNodeAllocator() = default;
+    explicit HeapNodeAllocator(std::pmr::memory_resource* resource) : resource_(resource) {}
+
+    template <typename Node>
+    NodePtr<Node> make() {
+        return NodePtr<Node>(new (resource_) Node());
+    }
+};
+
+
+
+/**
+ * @brief Node allocation policy that packs the nodes of a tree into slabs
+ *
+ * @details
+ * Each node size gets a NodePool of its own (a tree has two: leaves and internal
+ * nodes), whose slabs come from the memory resource the policy was given, or the
+ * default resource. Nodes freed by merges and clear() go back on the free lists for
+ * the next splits. When the policy goes away it orphans its pools, so the slabs go
+ * back upstream in one go once the last node in them has been reclaimed.
+ *
+ * A copy draws on the same resource with pools of its own; a move takes the pools
+ * along.
+ */
+
+class SlabNodeAllocator {
+  private:
+
+    static constexpr size_t max_pools = 2;
+
+    std::pmr::memory_resource* upstream_ = std::pmr::get_default_resource();
+    std::array<std::atomic<NodePool*>, max_pools> pools_{};
+
+    // The pool for allocations of the given size, created on first use. Writers that
+    // race to create it agree on a single one.
+    NodePool& pool(size_t bytes) {
+        for (auto& entry : pools_) {
+            NodePool* pool = entry.load(std::memory_order_acquire);
+            if (!pool) {
+                NodePool* created = new NodePool(bytes, upstream_);
+                if (entry.compare_exchange_strong(pool, created, std::memory_order_acq_rel)) {
+                    return *created;
+                }
+                created->orphan();
+            }
+            if (pool->slot_bytes() >= bytes && pool->slot_bytes() < bytes + alignof(std::max_align_t)) {
+                return *pool;
+            }
+        }
+        throw std::bad_alloc();  // more node sizes than a tree has
+    }
+
+    void release() {
+        for (auto& entry : pools_) {
+            if (NodePool* pool = entry.exchange(nullptr)) {
+                pool->orphan();
+            }
+        }
+    }
+
+  public:
+
+    SlabNodeAllocator() = default;
+    explicit SlabNodeAllocator(std::pmr::memory_resource* upstream) : upstream_(upstream) {}
+
+    SlabNodeAllocator(const SlabNodeAllocator& other) : upstream_(other.upstream_) {}
+
+    SlabNodeAllocator(SlabNodeAllocator&& other) noexcept : upstream_(other.upstream_) {
+        for (size_t i = 0; i < max_pools; ++i) {
+            pools_[i].store(other.pools_[i].exchange(nullptr));
+        }
+    }
+
+    SlabNodeAllocator& operator=(const SlabNodeAllocator& other) {
+        if (this != &other) {
+            release();
+            upstream_ = other.upstream_;
+        }
+        return *this;
+    }
+
+    SlabNodeAllocator& operator=(SlabNodeAllocator&& other) noexcept {
+        if (this != &other) {
+            release();
+            upstream_ = other.upstream_;
+            for (size_t i = 0; i < max_pools; ++i) {
+                pools_[i].store(other.pools_[i].exchange(nullptr));
+            }
+        }
+        return *this;
+    }
+
+    ~SlabNodeAllocator() {
+        release();
+    }
+
+    template <typename Node>
+    NodePtr<Node> make() {
+        static_assert(alignof(Node) <= alignof(std::max_align_t), "node slots are max_align_t aligned");
+        return NodePtr<Node>(new (&pool(ResourceAllocated::allocation_size(sizeof(Node)))) Node());
+    }
+};
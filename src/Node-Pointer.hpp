@@ -0,0 +1,176 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+
+/**
+ * @brief Reference count embedded in every tree node
+ *
+ * @details
+ * Nodes count their owners themselves, so an owning pointer is a single machine word
+ * and a node needs no separate control block. The count is only touched when an
+ * owner is copied or dropped, never by readers descending the tree.
+ */
+
+struct RefCounted {
+    mutable std::atomic<size_t> references_{0};
+
+    RefCounted() = default;
+    RefCounted(const RefCounted&) = delete;
+    RefCounted& operator=(const RefCounted&) = delete;
+};
+
+
+
+/**
+ * @brief Owning pointer to a reference counted node
+ *
+ * @details
+ * Behaves like a shared pointer whose count lives in the node. The last owner to let
+ * go deletes the node, which hands the memory back to wherever the node's class
+ * operator new took it from.
+ */
+
+template <typename Node>
+class NodePtr {
+  private:
+
+    template <typename, typename> friend class ChildPtr;
+
+    Node* node_ = nullptr;
+
+    static void acquire(Node* node) noexcept {
+        if (node) {
+            node->references_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    static void release(Node* node) noexcept {
+        if (node && node->references_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete node;
+        }
+    }
+
+  public:
+
+    NodePtr() noexcept = default;
+    NodePtr(std::nullptr_t) noexcept {}
+
+    // Takes ownership of a freshly allocated node, or shares one that is already owned
+    explicit NodePtr(Node* node) noexcept : node_(node) { acquire(node_); }
+
+    NodePtr(const NodePtr& other) noexcept : node_(other.node_) { acquire(node_); }
+    NodePtr(NodePtr&& other) noexcept : node_(std::exchange(other.node_, nullptr)) {}
+
+    NodePtr& operator=(NodePtr other) noexcept {
+        std::swap(node_, other.node_);
+        return *this;
+    }
+
+    ~NodePtr() { release(node_); }
+
+    Node* get() const noexcept { return node_; }
+    Node* operator->() const noexcept { return node_; }
+    Node& operator*() const noexcept { return *node_; }
+    explicit operator bool() const noexcept { return node_ != nullptr; }
+
+    bool operator==(const NodePtr& other) const noexcept { return node_ == other.node_; }
+    bool operator!=(const NodePtr& other) const noexcept { return node_ != other.node_; }
+    bool operator==(std::nullptr_t) const noexcept { return node_ == nullptr; }
+    bool operator!=(std::nullptr_t) const noexcept { return node_ != nullptr; }
+
+    void reset() noexcept { release(std::exchange(node_, nullptr)); }
+};
+
+
+
+/**
+ * @brief Owning pointer to the child of an internal node: either kind of node, or none
+ *
+ * @details
+ * The kind is kept in the lowest bit of the address, which is always clear since
+ * nodes are aligned to at least max_align_t. A child slot is therefore one word
+ * instead of a variant of two counted pointers and a discriminator, and telling a
+ * leaf from an internal node is a bit test rather than a variant dispatch.
+ *
+ * A slot is read and replaced as a single relaxed atomic word, so an optimistic reader
+ * racing a writer sees either the old child or the new one before it validates. Each
+ * accessor loads the word once, so the tag and the address always belong together.
+ */
+
+template <typename Internal, typename Leaf>
+class ChildPtr {
+  private:
+
+    static constexpr uintptr_t leaf_tag = 1;
+
+    std::atomic<uintptr_t> bits_{0};
+
+    uintptr_t word() const noexcept { return bits_.load(std::memory_order_relaxed); }
+
+    static void acquire(uintptr_t bits) noexcept {
+        if (bits & leaf_tag) {
+            NodePtr<Leaf>::acquire(reinterpret_cast<Leaf*>(bits & ~leaf_tag));
+        } else {
+            NodePtr<Internal>::acquire(reinterpret_cast<Internal*>(bits));
+        }
+    }
+
+    static void release(uintptr_t bits) noexcept {
+        if (bits & leaf_tag) {
+            NodePtr<Leaf>::release(reinterpret_cast<Leaf*>(bits & ~leaf_tag));
+        } else {
+            NodePtr<Internal>::release(reinterpret_cast<Internal*>(bits));
+        }
+    }
+
+  public:
+
+    ChildPtr() noexcept = default;
+    ChildPtr(std::nullptr_t) noexcept {}
+
+    ChildPtr(NodePtr<Internal> node) noexcept
+        : bits_(reinterpret_cast<uintptr_t>(std::exchange(node.node_, nullptr))) {}
+
+    ChildPtr(NodePtr<Leaf> node) noexcept
+        : bits_(node ? reinterpret_cast<uintptr_t>(std::exchange(node.node_, nullptr)) | leaf_tag : 0) {}
+
+    ChildPtr(const ChildPtr& other) noexcept : bits_(other.word()) { acquire(word()); }
+    ChildPtr(ChildPtr&& other) noexcept : bits_(other.bits_.exchange(0, std::memory_order_relaxed)) {}
+
+    // The slot is replaced with one store; the old child is released afterwards
+    ChildPtr& operator=(ChildPtr other) noexcept {
+        uintptr_t old = bits_.exchange(other.word(), std::memory_order_relaxed);
+        other.bits_.store(old, std::memory_order_relaxed);
+        return *this;
+    }
+
+    ~ChildPtr() { release(word()); }
+
+    bool is_leaf() const noexcept { return word() & leaf_tag; }
+    bool is_internal() const noexcept {
+        uintptr_t bits = word();
+        return bits && !(bits & leaf_tag);
+    }
+    explicit operator bool() const noexcept { return word() != 0; }
+
+    // Non-owning access; nullptr if the child is of the other kind or missing
+    Leaf* leaf() const noexcept {
+        uintptr_t bits = word();
+        return (bits & leaf_tag) ? reinterpret_cast<Leaf*>(bits & ~leaf_tag) : nullptr;
+    }
+    Internal* internal() const noexcept {
+        uintptr_t bits = word();
+        return (bits & leaf_tag) ? nullptr : reinterpret_cast<Internal*>(bits);
+    }
+
+    // Shared ownership of the child, or an empty pointer if it is of the other kind
+    NodePtr<Leaf> leaf_ptr() const noexcept { return NodePtr<Leaf>(leaf()); }
+    NodePtr<Internal> internal_ptr() const noexcept { return NodePtr<Internal>(internal()); }
+
+    bool operator==(const ChildPtr& other) const noexcept { return word() == other.word(); }
+    bool operator!=(const ChildPtr& other) const noexcept { return word() != other.word(); }
+};
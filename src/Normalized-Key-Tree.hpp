@@ -0,0 +1,140 @@
+#pragma once
+
+#include "BP-Tree.hpp"
+#include "Key-Normalizer.hpp"
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+/**
+ * @class NormalizedKeyTree
+ * @brief A B+ tree over keys stored only in their normalized, memcmp-comparable form.
+ *
+ * Keys are encoded with KeyNormalizer on the way in, so every comparison in the tree
+ * compares plain bytes instead of walking the components of a CompositeKey. The
+ * encoded bytes are stored inline in a NormalizedKey, so nodes hold no pointers to
+ * chase, and leaves search the keys' 8-byte prefixes first (see PrefixedKeys). Keys
+ * are decoded again only where they are handed out.
+ *
+ * @tparam Key A type with a KeyNormalizer, typically a CompositeKey.
+ * @tparam RecordId The type of the stored ids.
+ * @tparam Order Leaf order of the underlying tree.
+ * @tparam KeyBytes Capacity of a stored key; keys whose encoding is longer are rejected
+ *         with std::length_error. 0 stores the encodings as std::string, without a limit.
+ */
+template <typename Key, typename RecordId, size_t Order = 128, size_t KeyBytes = 32>
+class NormalizedKeyTree {
+  public:
+
+    using StoredKey = std::conditional_t<KeyBytes == 0, std::string, NormalizedKey<KeyBytes>>;
+    using Tree = BPlusTree<StoredKey, RecordId, Order>;
+
+  private:
+
+    Tree tree_; // Keyed by the normalized bytes.
+
+    // Encodes through a per-thread buffer, so a lookup with an inline NormalizedKey
+    // does not allocate; a std::string key still copies the encoding
+    static StoredKey stored(const Key& key) {
+        thread_local std::string buffer;
+        buffer.clear();
+        KeyNormalizer<Key>::encode(buffer, key);
+        return StoredKey(buffer);
+    }
+
+    static Key decoded(const StoredKey& key) {
+        if constexpr (KeyBytes == 0) {
+            return denormalize_key<Key>(key);
+        } else {
+            return denormalize_key<Key>(key.view());
+        }
+    }
+
+  public:
+
+    NormalizedKeyTree() = default;
+    explicit NormalizedKeyTree(ConcurrencyMode mode) : tree_(mode) {}
+
+    /**
+     * @brief Inserts an id under a key.
+     */
+    template <typename T>
+    void insert(const Key& key, T&& id) {
+        tree_.insert(stored(key), std::forward<T>(id));
+    }
+
+    /**
+     * @brief Removes one entry with the given key.
+     */
+    void remove(const Key& key) {
+        tree_.remove(stored(key));
+    }
+
+    /**
+     * @brief Populates an empty tree from (key, id) pairs sorted by key.
+     *
+     * @param fill_factor Share of each node to fill (see BPlusTree::bulk_load).
+     */
+    template <typename ForwardIt>
+    void bulk_load(ForwardIt first, ForwardIt last, double fill_factor = 1.0) {
+        std::vector<std::pair<StoredKey, RecordId>> entries;
+        for (; first != last; ++first) {
+            entries.emplace_back(stored(first->first), first->second);
+        }
+        tree_.bulk_load(entries.begin(), entries.end(), fill_factor);
+    }
+
+    /**
+     * @brief Returns the ids stored under a key.
+     */
+    DynamicArray<RecordId> find(const Key& key) {
+        return tree_.find(stored(key));
+    }
+
+    /**
+     * @brief Returns the ids of the keys in [from, to], in key order.
+     */
+    DynamicArray<RecordId> range_search(const Key& from, const Key& to) {
+        return tree_.range_search(stored(from), stored(to));
+    }
+
+    /**
+     * @brief Returns the ids of the keys whose leading components equal those of prefix.
+     *
+     * The encoding of the leading components is a byte prefix of the encoding of every
+     * key that starts with them, so this is a byte prefix search on the underlying tree.
+     */
+    template <typename... Leading>
+    DynamicArray<RecordId> prefix_search(const CompositeKey<Leading...>& prefix) {
+        static_assert(is_leading_prefix<Key, CompositeKey<Leading...>>::value,
+                      "prefix_search needs the leading components of the key");
+        thread_local std::string buffer;
+        buffer.clear();
+        KeyNormalizer<CompositeKey<Leading...>>::encode(buffer, prefix);
+        return tree_.prefix_search(buffer);
+    }
+
+    /**
+     * @brief Streams the entries with keys in [from, to] to a visitor, in key order.
+     *
+     * @param visitor Called as visitor(key, id) with the decoded key; if it returns
+     *        bool, false stops the scan.
+     * @return The number of entries visited.
+     */
+    template <typename Visitor>
+    size_t scan(const Key& from, const Key& to, Visitor&& visitor) {
+        return tree_.scan(stored(from), stored(to),
+                          [&visitor](const StoredKey& bytes, const RecordId& id) {
+            return visitor(decoded(bytes), id);
+        });
+    }
+
+    /**
+     * @brief The underlying tree, keyed by the normalized bytes.
+     */
+    Tree& tree() noexcept { return tree_; }
+    const Tree& tree() const noexcept { return tree_; }
+};
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <shared_mutex>
+
+
+/**
+ * @brief Reader-writer latch that also supports optimistic (version-validated) reads
+ *
+ * @details
+ * Behaves like std::shared_mutex and satisfies the SharedMutex requirements, so
+ * std::unique_lock and std::shared_lock work with it. In addition, every exclusive
+ * acquire and release bumps a version counter, which is therefore odd while a writer
+ * holds the latch. An optimistic reader snapshots the version, reads the protected
+ * data without taking the latch, and then validates that the version did not move.
+ * Shared holders never touch the version, so they do not invalidate optimistic readers.
+ */
+
+class OptimisticLatch {
+  private:
+
+    std::shared_mutex mutex_;
+    std::atomic<uint64_t> version_{0};
+
+    void bump_locked() {
+        // Only the exclusive holder writes the version, so a plain load/store pair is enough
+        version_.store(version_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+  public:
+
+    OptimisticLatch() = default;
+    OptimisticLatch(const OptimisticLatch&) = delete;
+    OptimisticLatch& operator=(const OptimisticLatch&) = delete;
+
+    void lock() {
+        mutex_.lock();
+        bump_locked();
+        // Keep the protected writes from becoming visible before the odd version
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    bool try_lock() {
+        if (!mutex_.try_lock()) {
+            return false;
+        }
+        bump_locked();
+        std::atomic_thread_fence(std::memory_order_release);
+        return true;
+    }
+
+    void unlock() {
+        version_.store(version_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        mutex_.unlock();
+    }
+
+    void lock_shared() { mutex_.lock_shared(); }
+    bool try_lock_shared() { return mutex_.try_lock_shared(); }
+    void unlock_shared() { mutex_.unlock_shared(); }
+
+
+    /**
+     * @brief Takes a version snapshot for an optimistic read
+     *
+     * @param version Receives the current version
+     *
+     * @return false if a writer holds the latch; the read must be restarted
+     */
+    bool read_version(uint64_t& version) const {
+        version = version_.load(std::memory_order_acquire);
+        return (version & 1) == 0;
+    }
+
+    /**
+     * @brief Checks that nothing was written since read_version() returned the given version
+     *
+     * @return false if the data read in between may be inconsistent
+     */
+    bool validate(uint64_t version) const {
+        // Keep the optimistic reads from being performed after the version check
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return version_.load(std::memory_order_relaxed) == version;
+    }
+};
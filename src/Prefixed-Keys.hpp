@@ -0,0 +1,205 @@
+#pragma once
+
+#include "Composite-Key.hpp"
+#include "Fixed-Array.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <type_traits>
+
+
+/**
+ * @brief Order-preserving fixed-width prefix of a key
+ *
+ * @details
+ * A specialization sets enabled and provides `static uint64_t of(const Key&)` such
+ * that a < b implies of(a) <= of(b) under std::less<Key>. Equal prefixes say nothing,
+ * so a search compares the full keys only on a tie. Leaves of keys with a prefix keep
+ * the prefixes in an array of their own (see PrefixedKeys). Specialize for a key type
+ * to opt it in, or to opt out of one of the specializations below.
+ */
+
+template <typename Key>
+struct KeyPrefix {
+    static constexpr bool enabled = false;
+};
+
+
+/**
+ * @brief Byte-level access to keys that sort like their bytes
+ *
+ * @details
+ * Keys that share their first n bytes compare like what follows them, so a leaf can
+ * skip the bytes all of its keys share when it takes their prefixes, and a separator
+ * only needs as many bytes as it takes to tell two neighbouring keys apart. A
+ * specialization sets enabled and provides, under std::less<Key>:
+ *
+ * - `static size_t length(const Key& key)`: the number of bytes of key.
+ * - `static size_t shared(const Key& a, const Key& b)`: how many leading bytes a and b share.
+ * - `static uint64_t prefix(const Key& key, size_t offset)`: like KeyPrefix<Key>::of(),
+ *   for the bytes from offset on.
+ * - `static Key separator(const Key& left, const Key& right)`: for left < right, the
+ *   shortest key s with left < s <= right.
+ */
+
+template <typename Key>
+struct KeyStem {
+    static constexpr bool enabled = false;
+};
+
+
+template <>
+struct KeyStem<std::string> {
+    static constexpr bool enabled = true;
+
+    static size_t length(const std::string& key) noexcept { return key.size(); }
+
+    static size_t shared(const std::string& a, const std::string& b) noexcept {
+        size_t length = a.size() < b.size() ? a.size() : b.size();
+        size_t i = 0;
+        while (i < length && a[i] == b[i]) {
+            ++i;
+        }
+        return i;
+    }
+
+    static uint64_t prefix(const std::string& key, size_t offset) noexcept {
+        uint64_t prefix = 0;
+        size_t length = key.size() > offset ? key.size() - offset : 0;
+        for (size_t i = 0; i < 8; ++i) {
+            prefix = (prefix << 8) | (i < length ? static_cast<unsigned char>(key[offset + i]) : 0);
+        }
+        return prefix;
+    }
+
+    // The bytes right shares with left and the first one in which it is greater
+    static std::string separator(const std::string& left, const std::string& right) {
+        size_t length = shared(left, right) + 1;
+        return length < right.size() ? right.substr(0, length) : right;
+    }
+};
+
+
+// The first eight bytes, big-endian and zero-padded, compare like the string itself
+template <>
+struct KeyPrefix<std::string> {
+    static constexpr bool enabled = true;
+
+    static uint64_t of(const std::string& key) noexcept {
+        return KeyStem<std::string>::prefix(key, 0);
+    }
+};
+
+
+// Composite keys compare their first component first, so its prefix will do
+template <typename First, typename... Rest>
+struct KeyPrefix<CompositeKey<First, Rest...>> {
+    static constexpr bool enabled = KeyPrefix<First>::enabled;
+
+    static uint64_t of(const CompositeKey<First, Rest...>& key) noexcept {
+        return KeyPrefix<First>::of(key.template get<0>());
+    }
+};
+
+
+
+/**
+ * @brief Leaf key array with a hot array of key prefixes in front of the full keys
+ *
+ * @details
+ * For keys such as strings, every comparison during a search follows a pointer out
+ * of the node. Here the search runs over a contiguous array of 8-byte prefixes
+ * instead, with the SIMD kernel of key_lower_bound(), and only reads the full keys
+ * among the entries whose prefix equals the search key's. The array keeps the natural
+ * alignment of the leaf, which nodes are allocated at (see ResourceAllocated).
+ *
+ * Keys with a KeyStem are prefixed from the end of the stem that all keys in the
+ * array share, which is kept once per array. Long common prefixes, as in path-like
+ * string keys, would otherwise leave every prefix equal and the search to the full keys.
+ *
+ * The interface is the subset of FixedArray that the tree uses on leaf keys, except
+ * that elements can only be changed through the array, which keeps the prefixes in
+ * step with the keys.
+ *
+ * @tparam Key Key type with an enabled KeyPrefix
+ * @tparam Capacity Maximum number of keys
+ */
+
+template <typename Key, size_t Capacity>
+class PrefixedKeys {
+  private:
+
+    std::array<uint64_t, Capacity> prefixes_{};
+    FixedArray<Key, Capacity> keys_;
+    size_t stem_ = 0;  // Leading bytes all keys share (with a KeyStem); the prefixes start after them
+
+    uint64_t prefix_of(const Key& key) const noexcept;
+
+    // Recomputes the prefixes of [from, size())
+    void refresh(size_t from) noexcept;
+
+    // Shortens the stem to the bytes key shares with the keys, before key is added
+    void narrow_stem(const Key& key) noexcept;
+
+    // Recomputes the stem after keys were replaced, and the prefixes of [from, size()),
+    // or all of them if the stem moved
+    void reset_stem(size_t from) noexcept;
+
+  public:
+
+    using value_type = Key;
+    using iterator = const Key*;
+    using const_iterator = const Key*;
+
+    PrefixedKeys() = default;
+
+    static constexpr size_t capacity() noexcept { return Capacity; }
+
+    size_t size() const noexcept { return keys_.size(); }
+    bool empty() const noexcept { return keys_.empty(); }
+
+    const_iterator begin() const noexcept { return keys_.begin(); }
+    const_iterator end() const noexcept { return keys_.end(); }
+    const uint64_t* prefixes() const noexcept { return prefixes_.data(); }
+    size_t stem() const noexcept { return stem_; }
+
+    const Key& operator[](size_t index) const noexcept { return keys_[index]; }
+    const Key& front() const noexcept { return keys_.front(); }
+    const Key& back() const noexcept { return keys_.back(); }
+
+    void push_back(const Key& key);
+    void push_back(Key&& key);
+    void pop_back();
+
+    const_iterator insert(const_iterator pos, const Key& key);
+    const_iterator insert(const_iterator pos, Key&& key);
+
+    template <typename InputIt>
+    const_iterator insert(const_iterator pos, InputIt first, InputIt last);
+
+    const_iterator erase(const_iterator pos);
+
+    template <typename InputIt>
+    void assign(InputIt first, InputIt last);
+
+    void resize(size_t count);
+    void clear();
+
+    template <typename Compare>
+    size_t lower_bound(size_t from, size_t to, const Key& key, const Compare& comp) const;
+};
+
+
+// How a leaf stores its keys: with a prefix array if the key type has a prefix
+template <typename Key, size_t Capacity>
+using LeafKeyArray = std::conditional_t<KeyPrefix<Key>::enabled, PrefixedKeys<Key, Capacity>, FixedArray<Key, Capacity>>;
+
+
+// Whether a tree searches its leaves by prefix: the prefixes follow std::less only
+template <typename Key, typename Compare>
+inline constexpr bool prefix_searchable =
+    KeyPrefix<Key>::enabled && (std::is_same_v<Compare, std::less<Key>> || std::is_same_v<Compare, std::less<>>);
+
+#include "Prefixed-Keys.tpp"
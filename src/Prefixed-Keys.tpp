@@ -0,0 +1,193 @@
+#include "Prefixed-Keys.hpp"
+#include "Key-Search.hpp"
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+// ------------------------- PREFIXED KEYS IMPLEMENTATION --------------------------
+
+
+template <typename Key, size_t Capacity>
+uint64_t PrefixedKeys<Key, Capacity>::prefix_of(const Key& key) const noexcept {
+    if constexpr (KeyStem<Key>::enabled) {
+        return KeyStem<Key>::prefix(key, stem_);
+    } else {
+        return KeyPrefix<Key>::of(key);
+    }
+}
+
+
+template <typename Key, size_t Capacity>
+void PrefixedKeys<Key, Capacity>::refresh(size_t from) noexcept {
+    for (size_t i = from; i < keys_.size(); ++i) {
+        prefixes_[i] = prefix_of(keys_[i]);
+    }
+}
+
+
+/**
+ * @details
+ * The stem only shrinks here, when a key arrives that does not share all of it. Erasing
+ * keys leaves it as it is, which stays correct: the keys still share it, and maybe more.
+ */
+
+template <typename Key, size_t Capacity>
+void PrefixedKeys<Key, Capacity>::narrow_stem(const Key& key) noexcept {
+    if constexpr (KeyStem<Key>::enabled) {
+        if (keys_.empty()) {
+            stem_ = KeyStem<Key>::length(key);
+            return;
+        }
+        size_t stem = KeyStem<Key>::shared(key, keys_.front());
+        if (stem < stem_) {
+            stem_ = stem;
+            refresh(0);
+        }
+    }
+}
+
+
+// Sorted keys share whatever the first and the last share
+template <typename Key, size_t Capacity>
+void PrefixedKeys<Key, Capacity>::reset_stem(size_t from) noexcept {
+    if constexpr (KeyStem<Key>::enabled) {
+        size_t stem = keys_.empty() ? 0 : KeyStem<Key>::shared(keys_.front(), keys_.back());
+        if (stem != stem_) {
+            stem_ = stem;
+            from = 0;
+        }
+    }
+    refresh(from);
+}
+
+
+template <typename Key, size_t Capacity>
+void PrefixedKeys<Key, Capacity>::push_back(const Key& key) {
+    narrow_stem(key);
+    prefixes_[keys_.size()] = prefix_of(key);
+    keys_.push_back(key);
+}
+
+template <typename Key, size_t Capacity>
+void PrefixedKeys<Key, Capacity>::push_back(Key&& key) {
+    narrow_stem(key);
+    prefixes_[keys_.size()] = prefix_of(key);
+    keys_.push_back(std::move(key));
+}
+
+template <typename Key, size_t Capacity>
+void PrefixedKeys<Key, Capacity>::pop_back() {
+    keys_.pop_back();
+    prefixes_[keys_.size()] = 0;
+}
+
+
+template <typename Key, size_t Capacity>
+typename PrefixedKeys<Key, Capacity>::const_iterator
+PrefixedKeys<Key, Capacity>::insert(const_iterator pos, const Key& key) {
+    Key copy = key;  // key may live in the range that is about to shift
+    return insert(pos, std::move(copy));
+}
+
+template <typename Key, size_t Capacity>
+typename PrefixedKeys<Key, Capacity>::const_iterator
+PrefixedKeys<Key, Capacity>::insert(const_iterator pos, Key&& key) {
+    size_t index = pos - begin();
+    narrow_stem(key);
+    uint64_t* prefixes = prefixes_.data();
+    std::move_backward(prefixes + index, prefixes + keys_.size(), prefixes + keys_.size() + 1);
+    prefixes[index] = prefix_of(key);
+    return keys_.insert(pos, std::move(key));
+}
+
+
+/**
+ * @brief Inserts the keys of [first, last) before pos
+ *
+ * @return Iterator to the first inserted key
+ */
+
+template <typename Key, size_t Capacity>
+template <typename InputIt>
+typename PrefixedKeys<Key, Capacity>::const_iterator
+PrefixedKeys<Key, Capacity>::insert(const_iterator pos, InputIt first, InputIt last) {
+    size_t index = pos - begin();
+    auto inserted = keys_.insert(pos, first, last);
+    reset_stem(index);
+    return inserted;
+}
+
+
+template <typename Key, size_t Capacity>
+typename PrefixedKeys<Key, Capacity>::const_iterator
+PrefixedKeys<Key, Capacity>::erase(const_iterator pos) {
+    size_t index = pos - begin();
+    uint64_t* prefixes = prefixes_.data();
+    std::move(prefixes + index + 1, prefixes + keys_.size(), prefixes + index);
+    prefixes[keys_.size() - 1] = 0;
+    return keys_.erase(pos);
+}
+
+
+template <typename Key, size_t Capacity>
+template <typename InputIt>
+void PrefixedKeys<Key, Capacity>::assign(InputIt first, InputIt last) {
+    clear();
+    keys_.assign(first, last);
+    reset_stem(0);
+}
+
+
+template <typename Key, size_t Capacity>
+void PrefixedKeys<Key, Capacity>::resize(size_t count) {
+    size_t old_size = keys_.size();
+    keys_.resize(count);
+    std::fill(prefixes_.begin() + std::min(count, old_size), prefixes_.begin() + old_size, 0);
+    reset_stem(old_size);
+}
+
+
+template <typename Key, size_t Capacity>
+void PrefixedKeys<Key, Capacity>::clear() {
+    resize(0);
+}
+
+
+/**
+ * @brief Position of the first key in [from, to) that is not less than key
+ *
+ * @details
+ * The prefixes narrow the range down to the keys that share the search key's prefix,
+ * with two SIMD searches over one contiguous array. Only those keys are compared in
+ * full, and none at all if the prefix already decides the position. A search key that
+ * leaves the stem goes before or after all keys, which one full comparison tells.
+ *
+ * @note comp must order keys like std::less (see prefix_searchable)
+ */
+
+template <typename Key, size_t Capacity>
+template <typename Compare>
+size_t PrefixedKeys<Key, Capacity>::lower_bound(size_t from, size_t to, const Key& key, const Compare& comp) const {
+
+    if constexpr (KeyStem<Key>::enabled) {
+        if (from == to) {
+            return from;
+        }
+        if (stem_ > 0 && KeyStem<Key>::shared(key, keys_[from]) < stem_) {
+            return comp(key, keys_[from]) ? from : to;
+        }
+    }
+
+    const uint64_t* prefixes = prefixes_.data();
+    const uint64_t prefix = prefix_of(key);
+    const std::less<uint64_t> less;
+
+    size_t first = key_lower_bound(prefixes + from, prefixes + to, prefix, less) - prefixes;
+    if (first == to || prefixes[first] != prefix) {
+        return first;
+    }
+
+    size_t last = prefix == UINT64_MAX ? to : key_lower_bound(prefixes + first, prefixes + to, prefix + 1, less) - prefixes;
+    const Key* keys = keys_.begin();
+    return std::lower_bound(keys + first, keys + last, key, comp) - keys;
+}
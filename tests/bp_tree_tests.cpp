@@ -4,6 +4,14 @@
 #include "../src/BP-Tree.hpp"
 #include "string"
 #include <thread>
+#include <atomic>
+#include <map>
+#include <set>
+#include <memory_resource>
+#include <random>
+#include <algorithm>
+#include <numeric>
+#include <vector>
 
 
 class BPlusTreeTest : public ::testing::Test {
@@ -368,6 +376,33 @@ TEST_F(BPlusTreeTest, IteratorTest) {
 }
 
 
+// A remove invalidates every iterator, since its merges may free the iterator's leaf;
+// erasing while iterating takes a new iterator after each remove
+TEST(BPlusTreeIteratorTest, RemoveWhileIteratingReseeks) {
+    BPlusTree<int, int, 4> tree;
+    for (int i = 0; i < 2000; ++i) {
+        tree.insert(i, i);
+    }
+
+    for (auto it = tree.begin(); it != tree.end();) {
+        int key = (*it).first_;
+        if (key % 2 == 1) {
+            tree.remove(key);
+            it = tree.lower_bound(key);
+        } else {
+            ++it;
+        }
+    }
+
+    int expected = 0;
+    for (const auto& pair : tree) {
+        ASSERT_EQ(pair.first_, expected);
+        expected += 2;
+    }
+    EXPECT_EQ(expected, 2000);
+}
+
+
 TEST_F(BPlusTreeTest, Height) {
     EXPECT_EQ(tree_->height(), 0);
     
@@ -412,3 +447,1374 @@ TEST_F(BPlusTreeTest, FillFactor) {
     
     EXPECT_LT(tree_->fill_factor(), 0.7);
 }
+
+
+TEST(BPlusTreeSmallOrderTest, RandomInsertRemoveMatchesMultimap) {
+    BPlusTree<int, int, 4> tree;
+    std::multimap<int, int> reference;
+    std::mt19937 rng(42);
+
+    for (int i = 0; i < 5000; ++i) {
+        int key = static_cast<int>(rng() % 500);
+        if (rng() % 3 == 0) {
+            tree.remove(key);
+            auto it = reference.find(key);
+            if (it != reference.end()) {
+                reference.erase(it);
+            }
+        } else {
+            tree.insert(key, i);
+            reference.emplace(key, i);
+        }
+    }
+
+    for (int key = 0; key < 500; ++key) {
+        ASSERT_EQ(tree.find(key).size(), reference.count(key)) << "key " << key;
+    }
+
+    std::vector<int> keys;
+    for (const auto& pair : tree) {
+        keys.push_back(pair.first_);
+    }
+    ASSERT_EQ(keys.size(), reference.size());
+    EXPECT_TRUE(std::is_sorted(keys.begin(), keys.end()));
+}
+
+TEST(BPlusTreeSmallOrderTest, DuplicatesAcrossLeaves) {
+    BPlusTree<int, int, 4> tree;
+    for (int i = 0; i < 20; ++i) {
+        tree.insert(7, i);
+    }
+    tree.insert(3, 100);
+    tree.insert(9, 200);
+
+    EXPECT_EQ(tree.find(7).size(), 20);
+
+    for (int i = 0; i < 20; ++i) {
+        tree.remove(7);
+    }
+    EXPECT_TRUE(tree.find(7).empty());
+    EXPECT_EQ(tree.find(3).size(), 1);
+    EXPECT_EQ(tree.find(9).size(), 1);
+}
+
+TEST(BPlusTreeSmallOrderTest, ShrinksBackToSingleLeaf) {
+    BPlusTree<int, int, 4> tree;
+    for (int i = 0; i < 1000; ++i) {
+        tree.insert(i, i);
+    }
+    EXPECT_GT(tree.height(), 3);
+
+    for (int i = 0; i < 999; ++i) {
+        tree.remove(i);
+    }
+    EXPECT_EQ(tree.height(), 1);
+    EXPECT_TRUE(tree.find(998).empty());
+    EXPECT_EQ(tree.find(999).size(), 1);
+}
+
+TEST(BPlusTreeNodeSizeTest, PolicyOrdersFitNodeBytes) {
+    using Small = NodeSizePolicy<4096>;
+    constexpr size_t leaf = Small::leaf_order<int64_t, uint64_t>;
+    constexpr size_t internal = Small::internal_order<int64_t, uint64_t>;
+    static_assert(sizeof(LeafNode<int64_t, uint64_t, leaf>) <= 4096);
+    static_assert(sizeof(LeafNode<int64_t, uint64_t, leaf + 1>) > 4096);
+    static_assert(sizeof(InternalNode<int64_t, uint64_t, leaf, internal>) <= 4096);
+    static_assert(sizeof(InternalNode<int64_t, uint64_t, leaf, internal + 1>) > 4096);
+    EXPECT_NE(leaf, internal);
+
+    using Large = NodeSizePolicy<16384>;
+    using Key = CompositeKey<std::string, int>;
+    static_assert(sizeof(LeafNode<Key, int, Large::leaf_order<Key, int>>) <= 16384);
+    static_assert(sizeof(InternalNode<Key, int, 4, Large::internal_order<Key, int>>) <= 16384);
+    static_assert(Large::leaf_order<Key, int> > Small::leaf_order<Key, int>);
+
+    // Too small a node for anything but the minimum order
+    static_assert(NodeSizePolicy<64>::leaf_order<int64_t, uint64_t> == 4);
+    static_assert(NodeSizePolicy<64>::internal_order<int64_t, uint64_t> == 4);
+}
+
+TEST(BPlusTreeNodeSizeTest, ChildSlotsAreTaggedWords) {
+    using Leaf = LeafNode<int, int, 4>;
+    using Internal = InternalNode<int, int, 4>;
+    static_assert(sizeof(VariantNode<int, int, 4>) == sizeof(void*));
+    static_assert(sizeof(NodePtr<Leaf>) == sizeof(void*));
+
+    HeapNodeAllocator allocator;
+    auto leaf = allocator.make<Leaf>();
+    VariantNode<int, int, 4> child = leaf;
+    EXPECT_TRUE(child.is_leaf());
+    EXPECT_FALSE(child.is_internal());
+    EXPECT_EQ(child.leaf(), leaf.get());
+    EXPECT_EQ(child.internal(), nullptr);
+    EXPECT_EQ(leaf->references_.load(), 2u);
+    {
+        auto copy = child;
+        EXPECT_EQ(copy, child);
+        EXPECT_EQ(leaf->references_.load(), 3u);
+    }
+    EXPECT_EQ(leaf->references_.load(), 2u);
+
+    child = allocator.make<Internal>();
+    EXPECT_TRUE(child.is_internal());
+    EXPECT_EQ(child.leaf(), nullptr);
+    EXPECT_EQ(child.internal()->references_.load(), 1u);
+    EXPECT_EQ(leaf->references_.load(), 1u);
+
+    child = nullptr;
+    EXPECT_FALSE(child);
+    EXPECT_FALSE(child.is_internal());
+}
+
+TEST(BPlusTreeNodeSizeTest, SizedTreeMatchesMultimap) {
+    SizedBPlusTree<int, int, NodeSizePolicy<512>> tree;
+    std::multimap<int, int> reference;
+    std::mt19937 rng(18);
+
+    for (int i = 0; i < 20000; ++i) {
+        int key = static_cast<int>(rng() % 4000);
+        if (rng() % 3 == 0) {
+            tree.remove(key);
+            auto it = reference.find(key);
+            if (it != reference.end()) {
+                reference.erase(it);
+            }
+        } else {
+            tree.insert(key, i);
+            reference.emplace(key, i);
+        }
+    }
+    EXPECT_GT(tree.height(), 2);
+
+    for (int key = 0; key < 4000; ++key) {
+        ASSERT_EQ(tree.find(key).size(), reference.count(key)) << "key " << key;
+    }
+    size_t visited = 0;
+    for (const auto& pair : tree) {
+        (void)pair;
+        ++visited;
+    }
+    EXPECT_EQ(visited, reference.size());
+}
+
+// Random inserts and removes on a tree whose leaves and internal nodes split at different sizes
+template <typename Tree>
+void check_mixed_orders(ConcurrencyMode mode) {
+    Tree tree(mode);
+    std::multimap<int, int> reference;
+    std::mt19937 rng(19);
+
+    for (int i = 0; i < 20000; ++i) {
+        int key = static_cast<int>(rng() % 2000);
+        if (rng() % 3 == 0) {
+            tree.remove(key);
+            auto it = reference.find(key);
+            if (it != reference.end()) {
+                reference.erase(it);
+            }
+        } else {
+            tree.insert(key, i);
+            reference.emplace(key, i);
+        }
+    }
+
+    for (int key = 0; key < 2000; ++key) {
+        ASSERT_EQ(tree.find(key).size(), reference.count(key)) << "key " << key;
+    }
+    EXPECT_EQ(tree.range_search(500, 1500).size(),
+              static_cast<size_t>(std::distance(reference.lower_bound(500), reference.upper_bound(1500))));
+
+    std::vector<int> keys;
+    for (const auto& pair : tree) {
+        keys.push_back(pair.first_);
+    }
+    ASSERT_EQ(keys.size(), reference.size());
+    EXPECT_TRUE(std::is_sorted(keys.begin(), keys.end()));
+}
+
+TEST(BPlusTreeMixedOrderTest, RandomInsertRemoveMatchesMultimap) {
+    for (auto mode : {ConcurrencyMode::LatchCoupling, ConcurrencyMode::BLink}) {
+        check_mixed_orders<BPlusTree<int, int, 4, std::less<int>, 16>>(mode);
+        check_mixed_orders<BPlusTree<int, int, 16, std::less<int>, 4>>(mode);
+    }
+}
+
+TEST(BPlusTreeMixedOrderTest, HeightAndFillFactorFollowEachOrder) {
+    std::vector<std::pair<int, int>> entries;
+    for (int i = 0; i < 9000; ++i) {
+        entries.emplace_back(i, i);
+    }
+
+    // 3000 full leaves of 3 entries under 48 internal nodes of up to 63 children
+    BPlusTree<int, int, 4, std::less<int>, 64> wide;
+    wide.bulk_load(entries.begin(), entries.end());
+    EXPECT_EQ(wide.height(), 3u);
+    EXPECT_DOUBLE_EQ(wide.fill_factor(), (9000.0 + 2952 + 47) / (9000 + 48 * 63 + 63));
+
+    // 143 leaves of up to 63 entries under levels of 48, 16, 6 and 2 internal nodes
+    BPlusTree<int, int, 64, std::less<int>, 4> narrow;
+    narrow.bulk_load(entries.begin(), entries.end());
+    EXPECT_EQ(narrow.height(), 6u);
+
+    // Updates keep both trees searchable and shrink them back to a single leaf
+    for (int i = 0; i < 9000; ++i) {
+        wide.remove(i);
+        narrow.remove(i);
+    }
+    EXPECT_TRUE(wide.empty());
+    EXPECT_TRUE(narrow.empty());
+    for (int i = 0; i < 100; ++i) {
+        wide.insert(i, i);
+        narrow.insert(i, i);
+    }
+    EXPECT_EQ(wide.height(), 2u);
+    EXPECT_EQ(narrow.height(), 2u);
+}
+
+// Forwards to the global heap and keeps track of what is still allocated
+class CountingResource : public std::pmr::memory_resource {
+  public:
+    std::atomic<size_t> allocations{0};
+    std::atomic<ptrdiff_t> outstanding{0};
+
+  protected:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        ++allocations;
+        outstanding += static_cast<ptrdiff_t>(bytes);
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* pointer, size_t bytes, size_t alignment) override {
+        outstanding -= static_cast<ptrdiff_t>(bytes);
+        std::pmr::new_delete_resource()->deallocate(pointer, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+TEST(BPlusTreeNodeAllocatorTest, SlabTreeMatchesMultimap) {
+    using Tree = BPlusTree<int, int, 8, std::less<int>, 8, SlabNodeAllocator>;
+    CountingResource upstream;
+    std::multimap<int, int> reference;
+
+    {
+        Tree tree(&upstream);
+        std::mt19937 rng(20);
+        for (int i = 0; i < 20000; ++i) {
+            int key = static_cast<int>(rng() % 5000);
+            if (rng() % 3 == 0) {
+                tree.remove(key);
+                auto it = reference.find(key);
+                if (it != reference.end()) {
+                    reference.erase(it);
+                }
+            } else {
+                tree.insert(key, i);
+                reference.emplace(key, i);
+            }
+        }
+
+        // Thousands of nodes in a few dozen slabs
+        EXPECT_GT(tree.height(), 3u);
+        EXPECT_LT(upstream.allocations.load(), 40u);
+
+        Tree copy(tree);
+        Tree moved(std::move(tree));
+        tree.insert(1, 1);
+        for (int key = 0; key < 5000; ++key) {
+            ASSERT_EQ(copy.find(key).size(), reference.count(key)) << "key " << key;
+            ASSERT_EQ(moved.find(key).size(), reference.count(key)) << "key " << key;
+        }
+        EXPECT_EQ(tree.find(1).size(), 1u);
+
+        copy = std::move(tree);
+        moved.clear();
+        EXPECT_TRUE(moved.empty());
+        EXPECT_EQ(copy.find(1).size(), 1u);
+    }
+
+    // Every slab went back upstream with the last node in it
+    EXPECT_EQ(upstream.outstanding.load(), 0);
+}
+
+TEST(BPlusTreeNodeAllocatorTest, NodesComeFromTheResource) {
+    CountingResource upstream;
+    {
+        std::pmr::monotonic_buffer_resource arena(&upstream);
+        BPlusTree<int, int, 16> tree(&arena, ConcurrencyMode::BLink);
+        for (int i = 0; i < 10000; ++i) {
+            tree.insert(i, i);
+        }
+        EXPECT_GT(upstream.outstanding.load(), static_cast<ptrdiff_t>(10000 * 2 * sizeof(int)));
+        for (int i = 0; i < 10000; i += 2) {
+            tree.remove(i);
+        }
+        EXPECT_EQ(tree.find(9999).size(), 1u);
+    }
+    EXPECT_EQ(upstream.outstanding.load(), 0);
+}
+
+TEST(BPlusTreeNodeAllocatorTest, ConcurrentWritersShareSlabs) {
+    using Tree = BPlusTree<int, int, 8, std::less<int>, 8, SlabNodeAllocator>;
+    std::pmr::synchronized_pool_resource upstream;
+    Tree tree(&upstream, ConcurrencyMode::BLink);
+    const int THREADS = 4;
+    const int KEYS = 5000;
+
+    std::vector<std::thread> writers;
+    for (int t = 0; t < THREADS; ++t) {
+        writers.emplace_back([&tree, t]() {
+            for (int i = 0; i < KEYS; ++i) {
+                tree.insert(i * THREADS + t, t);
+            }
+            for (int i = 0; i < KEYS; i += 2) {
+                tree.remove(i * THREADS + t);
+            }
+        });
+    }
+    for (auto& writer : writers) {
+        writer.join();
+    }
+
+    for (int key = 0; key < KEYS * THREADS; ++key) {
+        ASSERT_EQ(tree.find(key).size(), (key / THREADS) % 2 == 1 ? 1u : 0u) << "key " << key;
+    }
+}
+
+TEST(BPlusTreeScanTest, VisitsRangeInOrderAndStopsEarly) {
+    BPlusTree<int, int, 8> tree;
+    for (int i = 0; i < 1000; ++i) {
+        tree.insert(i / 2, i);  // every key twice
+    }
+
+    std::vector<int> keys;
+    size_t visited = tree.scan(100, 199, [&keys](const int& key, const int& id) {
+        EXPECT_EQ(key, id / 2);
+        keys.push_back(key);
+    });
+    EXPECT_EQ(visited, 200u);
+    ASSERT_EQ(keys.size(), 200u);
+    EXPECT_EQ(keys.front(), 100);
+    EXPECT_EQ(keys.back(), 199);
+    EXPECT_TRUE(std::is_sorted(keys.begin(), keys.end()));
+
+    // A visitor returning false ends the scan after that entry
+    int seen = 0;
+    visited = tree.scan(0, 499, [&seen](const int&, const int&) {
+        return ++seen < 5;
+    });
+    EXPECT_EQ(visited, 5u);
+    EXPECT_EQ(seen, 5);
+
+    EXPECT_EQ(tree.scan(600, 700, [](const int&, const int&) {}), 0u);
+}
+
+TEST(BPlusTreePagedRangeTest, PagesResumeAcrossDuplicates) {
+    BPlusTree<int, int, 8> tree;
+    for (int i = 0; i < 300; ++i) {
+        tree.insert(i / 3, i);  // every key three times
+    }
+
+    auto first = tree.range_search(10, 50, 4);
+    ASSERT_EQ(first.size(), 4u);
+    EXPECT_EQ(first[0] / 3, 10);
+
+    // Pages of 7 end in the middle of duplicate runs; together they must cover the
+    // range exactly once
+    decltype(tree)::RangeCursor cursor;
+    std::vector<int> ids;
+    size_t pages = 0;
+    while (!cursor.exhausted) {
+        auto page = tree.range_search(10, 50, 7, cursor);
+        EXPECT_LE(page.size(), 7u);
+        for (size_t i = 0; i < page.size(); ++i) {
+            ids.push_back(page[i]);
+        }
+        ++pages;
+    }
+    EXPECT_EQ(pages, 18u);  // 123 entries
+    std::vector<int> expected(123);
+    std::iota(expected.begin(), expected.end(), 30);
+    std::sort(ids.begin(), ids.end());
+    EXPECT_EQ(ids, expected);
+
+    EXPECT_TRUE(tree.range_search(10, 50, 7, cursor).empty());
+}
+
+TEST(BPlusTreeReverseTest, MatchesForwardOrder) {
+    for (auto mode : {ConcurrencyMode::LatchCoupling, ConcurrencyMode::BLink}) {
+        BPlusTree<int, int, 4> tree(mode);
+        std::mt19937 rng(5);
+        for (int i = 0; i < 3000; ++i) {
+            int key = static_cast<int>(rng() % 300);
+            if (rng() % 3 == 0) {
+                tree.remove(key);
+            } else {
+                tree.insert(key, i);
+            }
+        }
+
+        std::vector<int> forward;
+        for (const auto& pair : tree) {
+            forward.push_back(pair.second_);
+        }
+        std::vector<int> backward;
+        for (auto it = tree.rbegin(); it != tree.rend(); ++it) {
+            backward.push_back((*it).second_);
+        }
+        std::reverse(backward.begin(), backward.end());
+        EXPECT_EQ(backward, forward);
+
+        auto last = tree.end();
+        --last;
+        EXPECT_EQ((*last).second_, forward.back());
+
+        auto range = tree.range_search(50, 250);
+        auto reversed = tree.reverse_range_search(250, 50);
+        ASSERT_EQ(reversed.size(), range.size());
+        for (size_t i = 0; i < range.size(); ++i) {
+            ASSERT_EQ(reversed[i], range[range.size() - 1 - i]) << "position " << i;
+        }
+
+        auto top = tree.reverse_range_search(250, 50, 10);
+        ASSERT_EQ(top.size(), 10u);
+        for (size_t i = 0; i < top.size(); ++i) {
+            EXPECT_EQ(top[i], reversed[i]);
+        }
+        EXPECT_TRUE(tree.reverse_range_search(50, 250).empty());
+    }
+}
+
+TEST(BPlusTreeReverseTest, ConcurrentWritersAndReverseReaders) {
+    for (auto mode : {ConcurrencyMode::LatchCoupling, ConcurrencyMode::BLink}) {
+        BPlusTree<int, int, 8> tree(mode);
+        const int KEYS = 4000;
+
+        // Multiples of 10 stay in the tree; writers churn everything else
+        for (int key = 0; key < KEYS; key += 10) {
+            tree.insert(key, key);
+        }
+
+        std::atomic<bool> writers_done{false};
+        std::vector<std::thread> writers;
+        for (int w = 0; w < 2; ++w) {
+            writers.emplace_back([&tree, w]() {
+                std::mt19937 rng(w);
+                for (int i = 0; i < 20000; ++i) {
+                    int key = static_cast<int>(rng() % KEYS);
+                    if (key % 10 == 0) {
+                        continue;
+                    }
+                    if (rng() % 2 == 0) {
+                        tree.insert(key, key);
+                    } else {
+                        tree.remove(key);
+                    }
+                }
+            });
+        }
+
+        std::thread reader([&tree, &writers_done, KEYS]() {
+            while (!writers_done.load()) {
+                auto ids = tree.reverse_range_search(KEYS, 0);
+                size_t stable = 0;
+                for (size_t i = 0; i < ids.size(); ++i) {
+                    ASSERT_TRUE(i == 0 || ids[i - 1] >= ids[i]);
+                    stable += ids[i] % 10 == 0;
+                }
+                ASSERT_EQ(stable, static_cast<size_t>(KEYS / 10));
+            }
+        });
+
+        for (auto& writer : writers) {
+            writer.join();
+        }
+        writers_done = true;
+        reader.join();
+    }
+}
+
+TEST(BPlusTreeSeekTest, BoundsMatchMultimap) {
+    for (auto mode : {ConcurrencyMode::LatchCoupling, ConcurrencyMode::BLink}) {
+        BPlusTree<int, int, 4> tree(mode);
+        std::multimap<int, int> reference;
+        std::mt19937 rng(9);
+        for (int i = 0; i < 2000; ++i) {
+            int key = static_cast<int>(rng() % 100) * 2;  // even keys, with duplicates
+            tree.insert(key, i);
+            reference.emplace(key, i);
+        }
+
+        auto position = [&reference](std::multimap<int, int>::iterator it) {
+            return static_cast<size_t>(std::distance(reference.begin(), it));
+        };
+        for (int key = -1; key <= 201; ++key) {
+            size_t remaining_lower = 0;
+            for (auto it = tree.lower_bound(key); it != tree.end(); ++it) {
+                ++remaining_lower;
+            }
+            size_t remaining_upper = 0;
+            for (auto it = tree.upper_bound(key); it != tree.end(); ++it) {
+                ++remaining_upper;
+            }
+            EXPECT_EQ(remaining_lower, reference.size() - position(reference.lower_bound(key))) << "key " << key;
+            EXPECT_EQ(remaining_upper, reference.size() - position(reference.upper_bound(key))) << "key " << key;
+
+            auto [first, last] = tree.equal_range(key);
+            size_t equal = 0;
+            for (; first != last; ++first) {
+                EXPECT_EQ((*first).first_, key);
+                ++equal;
+            }
+            EXPECT_EQ(equal, reference.count(key)) << "key " << key;
+        }
+
+        // seek() only moves forward from where the iterator is
+        auto it = tree.begin();
+        it.seek(101);
+        ASSERT_NE(it, tree.end());
+        EXPECT_EQ((*it).first_, 102);
+        it.seek(50);
+        EXPECT_EQ((*it).first_, 102);
+        it.seek(1000);
+        EXPECT_EQ(it, tree.end());
+    }
+}
+
+TEST(BPlusTreeFindManyTest, MatchesFind) {
+    for (auto mode : {ConcurrencyMode::LatchCoupling, ConcurrencyMode::BLink}) {
+        BPlusTree<int, int, 8> tree(mode);
+        for (int i = 0; i < 5000; ++i) {
+            tree.insert(i % 1500, i);  // some keys twice, a few three times
+        }
+
+        std::vector<int> keys;
+        std::mt19937 rng(13);
+        for (int i = 0; i < 1000; ++i) {
+            keys.push_back(static_cast<int>(rng() % 2000) - 100);  // misses at both ends
+        }
+
+        auto results = tree.find_many(keys);
+        ASSERT_EQ(results.size(), keys.size());
+        for (size_t i = 0; i < keys.size(); ++i) {
+            auto expected = tree.find(keys[i]);
+            ASSERT_EQ(results[i].size(), expected.size()) << "key " << keys[i];
+            for (size_t j = 0; j < expected.size(); ++j) {
+                EXPECT_EQ(results[i][j], expected[j]);
+            }
+        }
+    }
+
+    // Keys that cannot be read optimistically take the latched path
+    BPlusTree<std::string, int, 8> strings;
+    strings.insert("b", 1);
+    strings.insert("a", 2);
+    std::vector<std::string> keys = {"a", "c", "b"};
+    auto results = strings.find_many(keys);
+    ASSERT_EQ(results.size(), 3u);
+    EXPECT_EQ(results[0].size(), 1u);
+    EXPECT_TRUE(results[1].empty());
+    EXPECT_EQ(results[2][0], 1);
+}
+
+TEST(BPlusTreeSearchHintTest, HintedOperationsMatchMultimap) {
+    for (auto mode : {ConcurrencyMode::LatchCoupling, ConcurrencyMode::BLink}) {
+        BPlusTree<int, int, 4> tree(mode);
+        BPlusTree<int, int, 4>::SearchHint hint;
+        std::multimap<int, int> reference;
+        std::mt19937 rng(17);
+
+        // A random walk, so most operations land in the leaf of the one before; the
+        // removes merge leaves under latch coupling and so invalidate the hint
+        int key = 500;
+        for (int i = 0; i < 20000; ++i) {
+            key = std::clamp(key + static_cast<int>(rng() % 7) - 3, 0, 1000);
+            switch (rng() % 4) {
+            case 0:
+            case 1:
+                tree.insert(key, i, hint);
+                reference.emplace(key, i);
+                break;
+            case 2:
+                if (auto it = reference.find(key); it != reference.end()) {
+                    tree.remove(key);
+                    reference.erase(it);
+                }
+                break;
+            default: {
+                auto found = tree.find(key, hint);
+                ASSERT_EQ(found.size(), reference.count(key)) << "key " << key;
+                auto it = tree.lower_bound(key, hint);
+                auto expected = reference.lower_bound(key);
+                if (expected == reference.end()) {
+                    EXPECT_EQ(it, tree.end());
+                } else {
+                    ASSERT_NE(it, tree.end());
+                    EXPECT_EQ((*it).first_, expected->first);
+                }
+            }
+            }
+        }
+        // The tree's contents are the same as without hints
+        auto it = tree.begin();
+        for (const auto& [expected, id] : reference) {
+            ASSERT_NE(it, tree.end());
+            EXPECT_EQ((*it).first_, expected);
+            ++it;
+        }
+        EXPECT_EQ(it, tree.end());
+
+        // A hint survives clear() and use on another tree
+        tree.clear();
+        EXPECT_TRUE(tree.find(key, hint).empty());
+        BPlusTree<int, int, 4> other(mode);
+        other.insert(1, 1, hint);
+        EXPECT_EQ(other.find(1, hint).size(), 1u);
+        EXPECT_TRUE(tree.find(1, hint).empty());
+    }
+}
+
+TEST(BPlusTreeSearchHintTest, ConcurrentHintedInsertsAndMergingRemoves) {
+    for (auto mode : {ConcurrencyMode::LatchCoupling, ConcurrencyMode::BLink}) {
+        BPlusTree<int, int, 4> tree(mode);
+        const int THREADS = 4;
+        const int STEPS = 20000;
+
+        // Every thread walks its own residue class of keys, so it alone knows how many
+        // copies of each of them the tree must hold; other threads' removes keep
+        // merging away the leaves its hint points to
+        std::vector<std::multiset<int>> owned(THREADS);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < THREADS; ++t) {
+            threads.emplace_back([&tree, &owned, t]() {
+                BPlusTree<int, int, 4>::SearchHint hint;
+                std::multiset<int>& mine = owned[t];
+                std::mt19937 rng(31 + t);
+                int step = 20;
+                for (int i = 0; i < STEPS; ++i) {
+                    step = std::clamp(step + static_cast<int>(rng() % 5) - 2, 0, 40);
+                    int key = step * THREADS + t;
+                    switch (rng() % 3) {
+                    case 0:
+                        tree.insert(key, i, hint);
+                        mine.insert(key);
+                        break;
+                    case 1:
+                        if (auto it = mine.find(key); it != mine.end()) {
+                            tree.remove(key);
+                            mine.erase(it);
+                        }
+                        break;
+                    default:
+                        ASSERT_EQ(tree.find(key, hint).size(), mine.count(key)) << "key " << key;
+                    }
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        // No hinted insert went to a leaf that had been merged away
+        std::multiset<int> expected;
+        for (const auto& mine : owned) {
+            expected.insert(mine.begin(), mine.end());
+        }
+        auto it = tree.begin();
+        for (int key : expected) {
+            ASSERT_NE(it, tree.end());
+            ASSERT_EQ((*it).first_, key);
+            ++it;
+        }
+        EXPECT_EQ(it, tree.end());
+    }
+}
+
+
+TEST(BPlusTreeSubtreeCountTest, CountRankSelectMatchMultimap) {
+    BPlusTree<int, int, 4> tree(ConcurrencyMode::LatchCoupling, SubtreeCounts::On);
+    std::multimap<int, int> reference;
+    std::mt19937 rng(19);
+
+    auto check = [&reference](BPlusTree<int, int, 4>& t) {
+        for (int key = -1; key <= 201; key += 3) {
+            size_t below = static_cast<size_t>(std::distance(reference.begin(), reference.lower_bound(key)));
+            ASSERT_EQ(t.rank(key), below) << "key " << key;
+            for (int to : {key - 1, key, key + 17}) {
+                size_t expected = to < key ? 0 : static_cast<size_t>(std::distance(
+                    reference.lower_bound(key), reference.upper_bound(to)));
+                ASSERT_EQ(t.count(key, to), expected) << "range " << key << ".." << to;
+            }
+        }
+        size_t k = 0;
+        for (const auto& [key, id] : reference) {
+            if (k % 7 == 0) {
+                auto it = t.select(k);
+                ASSERT_NE(it, t.end()) << "k " << k;
+                EXPECT_EQ((*it).first_, key);
+            }
+            ++k;
+        }
+        EXPECT_EQ(t.select(reference.size()), t.end());
+    };
+
+    // Single inserts and removes split, merge and rebalance nodes at every level
+    for (int i = 0; i < 3000; ++i) {
+        int key = static_cast<int>(rng() % 200);
+        if (rng() % 3 == 0) {
+            if (auto it = reference.find(key); it != reference.end()) {
+                reference.erase(it);
+            }
+            tree.remove(key);
+        } else {
+            tree.insert(key, i);
+            reference.emplace(key, i);
+        }
+    }
+    check(tree);
+
+    // Batches spread runs over several new leaves at once
+    std::vector<std::pair<int, int>> batch;
+    for (int i = 0; i < 500; ++i) {
+        batch.emplace_back(static_cast<int>(rng() % 200), i);
+    }
+    tree.insert_batch(batch);
+    reference.insert(batch.begin(), batch.end());
+    check(tree);
+
+    BPlusTree<int, int, 4> copy(tree);
+    check(copy);
+
+    std::vector<std::pair<int, int>> sorted(reference.begin(), reference.end());
+    BPlusTree<int, int, 4> loaded(ConcurrencyMode::LatchCoupling, SubtreeCounts::On);
+    loaded.bulk_load(sorted.begin(), sorted.end(), 0.6);
+    check(loaded);
+}
+
+
+TEST(BPlusTreeSubtreeCountTest, RequiresCountsAndLatchCoupling) {
+    BPlusTree<int, int, 4> plain;
+    plain.insert(1, 1);
+    EXPECT_THROW(plain.count(0, 2), std::logic_error);
+    EXPECT_THROW(plain.rank(1), std::logic_error);
+    EXPECT_THROW(plain.select(0), std::logic_error);
+
+    using Tree = BPlusTree<int, int, 4>;
+    EXPECT_THROW(Tree(ConcurrencyMode::BLink, SubtreeCounts::On), std::invalid_argument);
+}
+
+
+TEST(BPlusTreeSubtreeCountTest, ConcurrentWritersKeepCountsExact) {
+    BPlusTree<int, int, 8> tree(ConcurrencyMode::LatchCoupling, SubtreeCounts::On);
+    const int THREADS = 4;
+    const int KEYS = 2000;
+
+    // Every writer inserts its keys and removes every other one again; a reader checks
+    // that a count never exceeds what has been inserted so far
+    std::atomic<bool> done{false};
+    std::thread reader([&tree, &done]() {
+        while (!done.load()) {
+            EXPECT_LE(tree.count(0, THREADS * KEYS), static_cast<size_t>(THREADS * KEYS));
+        }
+    });
+
+    std::vector<std::thread> writers;
+    for (int t = 0; t < THREADS; ++t) {
+        writers.emplace_back([&tree, t, KEYS]() {
+            for (int i = 0; i < KEYS; ++i) {
+                tree.insert(t * KEYS + i, i);
+            }
+            for (int i = 0; i < KEYS; i += 2) {
+                tree.remove(t * KEYS + i);
+            }
+        });
+    }
+    for (auto& writer : writers) {
+        writer.join();
+    }
+    done = true;
+    reader.join();
+
+    EXPECT_EQ(tree.count(0, THREADS * KEYS), static_cast<size_t>(THREADS * KEYS / 2));
+    EXPECT_EQ(tree.rank(KEYS), static_cast<size_t>(KEYS / 2));
+    EXPECT_EQ((*tree.select(0)).first_, 1);
+}
+
+
+TEST(BPlusTreeAppendTest, AscendingInsertsPackLeaves) {
+    for (auto mode : {ConcurrencyMode::LatchCoupling, ConcurrencyMode::BLink}) {
+        BPlusTree<int, int, 16> tree(mode);
+        for (int i = 0; i < 10000; ++i) {
+            tree.insert(i, i);
+        }
+        EXPECT_GT(tree.fill_factor(), 0.95);
+
+        // Removing the tail retires the hinted leaf; appends must carry on correctly
+        for (int i = 9999; i >= 9000; --i) {
+            tree.remove(i);
+        }
+        for (int i = 9000; i < 12000; ++i) {
+            tree.insert(i, i);
+        }
+        tree.insert(5, -5);  // not an append
+
+        int expected = 0;
+        for (const auto& pair : tree) {
+            if (pair.second_ == -5) {
+                continue;
+            }
+            ASSERT_EQ(pair.first_, expected);
+            ++expected;
+        }
+        EXPECT_EQ(expected, 12000);
+        EXPECT_EQ(tree.find(5).size(), 2u);
+    }
+}
+
+TEST(BPlusTreeAppendTest, ConcurrentAppendersAndTailRemovers) {
+    for (auto mode : {ConcurrencyMode::LatchCoupling, ConcurrencyMode::BLink}) {
+        BPlusTree<int, int, 8> tree(mode);
+        std::atomic<int> next{0};
+        const int APPENDS = 20000;
+
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 2; ++t) {
+            threads.emplace_back([&tree, &next]() {
+                for (int key; (key = next.fetch_add(1)) < APPENDS; ) {
+                    tree.insert(key, key);
+                }
+            });
+        }
+        // Odd keys are removed behind the appenders, which empties and merges leaves
+        threads.emplace_back([&tree]() {
+            for (int key = 1; key < APPENDS; key += 2) {
+                while (tree.find(key).empty()) {
+                    std::this_thread::yield();
+                }
+                tree.remove(key);
+            }
+        });
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        for (int key = 0; key < APPENDS; ++key) {
+            ASSERT_EQ(tree.find(key).size(), key % 2 == 0 ? 1u : 0u) << "key " << key;
+        }
+    }
+}
+
+TEST(BPlusTreeBulkLoadTest, PackedTreeMatchesInput) {
+    // Runs of three duplicates, so some runs straddle leaf boundaries
+    std::vector<std::pair<int, int>> entries;
+    for (int i = 0; i < 3000; ++i) {
+        entries.emplace_back(i / 3, i);
+    }
+
+    for (double fill : {1.0, 0.7, 0.1}) {
+        BPlusTree<int, int, 8> tree;
+        tree.insert(-5, 0);  // replaced by the load
+        tree.bulk_load(entries.begin(), entries.end(), fill);
+
+        EXPECT_TRUE(tree.find(-5).empty());
+        for (int key = 0; key < 1000; ++key) {
+            ASSERT_EQ(tree.find(key).size(), 3u) << "key " << key << " fill " << fill;
+        }
+        EXPECT_EQ(tree.range_search(100, 199).size(), 300u);
+
+        size_t visited = 0;
+        for (const auto& pair : tree) {
+            EXPECT_EQ(pair.second_, static_cast<int>(visited));
+            ++visited;
+        }
+        EXPECT_EQ(visited, entries.size());
+    }
+
+    BPlusTree<int, int, 8> packed;
+    packed.bulk_load(entries.begin(), entries.end());
+    EXPECT_GT(packed.fill_factor(), 0.95);
+    EXPECT_LE(packed.height(), 5u);
+}
+
+TEST(BPlusTreeBulkLoadTest, LoadedTreeAcceptsUpdates) {
+    for (auto mode : {ConcurrencyMode::LatchCoupling, ConcurrencyMode::BLink}) {
+        std::vector<std::pair<int, int>> entries;
+        std::multimap<int, int> reference;
+        for (int i = 0; i < 2000; i += 2) {
+            entries.emplace_back(i, i);
+            reference.emplace(i, i);
+        }
+
+        BPlusTree<int, int, 8> tree(mode);
+        tree.bulk_load(entries.begin(), entries.end(), 0.9);
+
+        std::mt19937 rng(5);
+        for (int i = 0; i < 4000; ++i) {
+            int key = static_cast<int>(rng() % 2000);
+            if (rng() % 2 == 0) {
+                tree.remove(key);
+                auto it = reference.find(key);
+                if (it != reference.end()) {
+                    reference.erase(it);
+                }
+            } else {
+                tree.insert(key, i);
+                reference.emplace(key, i);
+            }
+        }
+
+        for (int key = 0; key < 2000; ++key) {
+            ASSERT_EQ(tree.find(key).size(), reference.count(key)) << "key " << key;
+        }
+    }
+}
+
+TEST(BPlusTreeBulkLoadTest, RejectsBadInput) {
+    BPlusTree<int, int, 8> tree;
+    tree.insert(1, 1);
+
+    std::vector<std::pair<int, int>> unsorted = {{1, 0}, {3, 0}, {2, 0}};
+    EXPECT_THROW(tree.bulk_load(unsorted.begin(), unsorted.end()), std::invalid_argument);
+    EXPECT_THROW(tree.bulk_load(unsorted.begin(), unsorted.begin(), 0.0), std::invalid_argument);
+    EXPECT_EQ(tree.find(1).size(), 1u);
+
+    tree.bulk_load(unsorted.begin(), unsorted.begin());
+    EXPECT_TRUE(tree.empty());
+    EXPECT_EQ(tree.height(), 0u);
+}
+
+TEST(BPlusTreeBulkLoadTest, DestroysLongLeafChains) {
+    // A million leaves: releasing them one recursive call per leaf overflows the stack
+    std::vector<std::pair<int, int>> entries;
+    for (int i = 0; i < 3'000'000; ++i) {
+        entries.emplace_back(i, i);
+    }
+
+    auto tree = std::make_unique<BPlusTree<int, int, 4>>();
+    tree->bulk_load(entries.begin(), entries.end());
+    EXPECT_EQ(tree->find(2'999'999).size(), 1u);
+    tree.reset();
+}
+
+TEST(BPlusTreeBatchInsertTest, MatchesSingleInserts) {
+    for (auto mode : {ConcurrencyMode::LatchCoupling, ConcurrencyMode::BLink}) {
+        BPlusTree<int, int, 8> tree(mode);
+        std::multimap<int, int> reference;
+        std::mt19937 rng(9);
+
+        // The first batch lands in an empty tree, later ones overlap existing keys
+        for (size_t batch_size : {500, 3000, 40, 1}) {
+            std::vector<std::pair<int, int>> batch;
+            for (size_t i = 0; i < batch_size; ++i) {
+                int key = static_cast<int>(rng() % 1500);
+                batch.emplace_back(key, static_cast<int>(reference.size()));
+                reference.emplace(key, static_cast<int>(reference.size()));
+            }
+            tree.insert_batch(batch);
+        }
+
+        for (int key = 0; key < 1500; ++key) {
+            ASSERT_EQ(tree.find(key).size(), reference.count(key)) << "key " << key;
+        }
+
+        std::vector<int> keys;
+        for (const auto& pair : tree) {
+            keys.push_back(pair.first_);
+        }
+        ASSERT_EQ(keys.size(), reference.size());
+        EXPECT_TRUE(std::is_sorted(keys.begin(), keys.end()));
+
+        // The tree stays consistent for ordinary writes afterwards
+        for (int key = 0; key < 1500; key += 3) {
+            tree.remove(key);
+            auto it = reference.find(key);
+            if (it != reference.end()) {
+                reference.erase(it);
+            }
+        }
+        for (int key = 0; key < 1500; ++key) {
+            ASSERT_EQ(tree.find(key).size(), reference.count(key)) << "key " << key;
+        }
+    }
+}
+
+TEST(BPlusTreeBatchInsertTest, ConcurrentBatchesAndReaders) {
+    BPlusTree<int, int, 8> tree;
+    const int THREADS = 4;
+    const int BATCHES = 20;
+    const int BATCH_SIZE = 250;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t) {
+        threads.emplace_back([&tree, t]() {
+            std::mt19937 rng(t);
+            for (int b = 0; b < BATCHES; ++b) {
+                // Keys of thread t are congruent to t modulo THREADS
+                std::vector<std::pair<int, int>> batch;
+                for (int i = 0; i < BATCH_SIZE; ++i) {
+                    int key = (b * BATCH_SIZE + i) * THREADS + t;
+                    batch.emplace_back(key, key);
+                }
+                std::shuffle(batch.begin(), batch.end(), rng);
+                tree.insert_batch(batch);
+            }
+        });
+    }
+    threads.emplace_back([&tree]() {
+        for (int i = 0; i < 2000; ++i) {
+            auto found = tree.find(i);
+            ASSERT_LE(found.size(), 1u);
+        }
+    });
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (int key = 0; key < THREADS * BATCHES * BATCH_SIZE; ++key) {
+        auto found = tree.find(key);
+        ASSERT_EQ(found.size(), 1u) << "key " << key;
+        EXPECT_EQ(found[0], key);
+    }
+}
+
+TEST(BPlusTreeConcurrencyTest, ConcurrentWritersAndReaders) {
+    BPlusTree<int, int, 8> tree;
+    const int WRITERS = 4;
+    const int KEYS_PER_WRITER = 4000;
+    std::atomic<bool> writers_done{false};
+    std::vector<std::thread> threads;
+
+    for (int w = 0; w < WRITERS; ++w) {
+        threads.emplace_back([&tree, w]() {
+            for (int i = 0; i < KEYS_PER_WRITER; ++i) {
+                int key = i * WRITERS + w;
+                tree.insert(key, key);
+            }
+            // Remove every odd key again, exercising borrows and merges
+            for (int i = 0; i < KEYS_PER_WRITER; ++i) {
+                int key = i * WRITERS + w;
+                if (key % 2 == 1) {
+                    tree.remove(key);
+                }
+            }
+        });
+    }
+
+    for (int r = 0; r < 2; ++r) {
+        threads.emplace_back([&tree, &writers_done]() {
+            while (!writers_done.load()) {
+                auto range = tree.range_search(100, 200);
+                for (size_t i = 1; i < range.size(); ++i) {
+                    ASSERT_LT(range[i - 1], range[i]);
+                }
+                tree.find(150);
+            }
+        });
+    }
+
+    for (int w = 0; w < WRITERS; ++w) {
+        threads[w].join();
+    }
+    writers_done = true;
+    for (size_t t = WRITERS; t < threads.size(); ++t) {
+        threads[t].join();
+    }
+
+    for (int key = 0; key < WRITERS * KEYS_PER_WRITER; ++key) {
+        ASSERT_EQ(tree.find(key).size(), key % 2 == 0 ? 1u : 0u) << "key " << key;
+    }
+}
+
+
+TEST(BPlusTreeConcurrencyTest, OptimisticReadersSeeStableKeys) {
+    static_assert(BPlusTree<int, int, 8>::optimistic_reads);
+    static_assert(!BPlusTree<std::string, int, 8>::optimistic_reads);
+
+    BPlusTree<int, int, 8> tree;
+    const int STABLE_KEYS = 500;
+
+    // Multiples of 10 stay in the tree for the whole test
+    for (int i = 0; i < STABLE_KEYS; ++i) {
+        tree.insert(i * 10, i * 10);
+    }
+
+    std::atomic<bool> writers_done{false};
+    std::vector<std::thread> threads;
+
+    // Writers keep splitting and merging the nodes around the stable keys
+    for (int w = 0; w < 2; ++w) {
+        threads.emplace_back([&tree, w]() {
+            for (int round = 0; round < 20; ++round) {
+                for (int i = 0; i < STABLE_KEYS; ++i) {
+                    tree.insert(i * 10 + 1 + w, 0);
+                }
+                for (int i = 0; i < STABLE_KEYS; ++i) {
+                    tree.remove(i * 10 + 1 + w);
+                }
+            }
+        });
+    }
+
+    for (int r = 0; r < 2; ++r) {
+        threads.emplace_back([&tree, &writers_done, r]() {
+            int key = r * 10;
+            while (!writers_done.load()) {
+                auto found = tree.find(key);
+                ASSERT_EQ(found.size(), 1u) << "key " << key;
+                ASSERT_EQ(found[0], key);
+
+                auto range = tree.range_search(1000, 2000);
+                int stable = 0;
+                for (size_t i = 0; i < range.size(); ++i) {
+                    if (range[i] != 0) {
+                        ASSERT_EQ(range[i], 1000 + stable * 10);
+                        ++stable;
+                    }
+                }
+                ASSERT_EQ(stable, 101);
+
+                std::vector<int> keys;
+                for (int i = 0; i < 40; ++i) {
+                    keys.push_back((key + i * 130) % (STABLE_KEYS * 10));
+                }
+                auto many = tree.find_many(keys);
+                for (size_t i = 0; i < keys.size(); ++i) {
+                    ASSERT_EQ(many[i].size(), 1u) << "key " << keys[i];
+                    ASSERT_EQ(many[i][0], keys[i]);
+                }
+
+                key = (key + 20) % (STABLE_KEYS * 10);
+            }
+        });
+    }
+
+    for (int w = 0; w < 2; ++w) {
+        threads[w].join();
+    }
+    writers_done = true;
+    for (size_t t = 2; t < threads.size(); ++t) {
+        threads[t].join();
+    }
+
+    for (int i = 0; i < STABLE_KEYS; ++i) {
+        ASSERT_EQ(tree.find(i * 10).size(), 1u);
+        ASSERT_EQ(tree.find(i * 10 + 1).size(), 0u);
+    }
+}
+
+
+TEST(BPlusTreeConcurrencyTest, EpochGuardHoldsBackReclamation) {
+    auto& domain = EpochDomain::global();
+
+    std::atomic<bool> entered{false};
+    std::atomic<bool> release{false};
+    std::thread reader([&]() {
+        EpochGuard guard;
+        entered = true;
+        while (!release.load()) {
+            std::this_thread::yield();
+        }
+    });
+    while (!entered.load()) {
+        std::this_thread::yield();
+    }
+
+    // Anything retired from now on is newer than the reader's epoch
+    uint64_t tag = domain.retire_epoch();
+    EXPECT_LE(domain.min_active_epoch(), tag);
+
+    release = true;
+    reader.join();
+    EXPECT_GT(domain.min_active_epoch(), tag);
+}
+
+
+TEST(BPlusTreeConcurrencyTest, ReadersSurviveClear) {
+    BPlusTree<std::string, int, 8> tree;
+    std::atomic<bool> writer_done{false};
+
+    // Each round builds a multi-level tree and then unlinks all of it at once
+    std::thread writer([&]() {
+        for (int round = 0; round < 50; ++round) {
+            for (int i = 0; i < 300; ++i) {
+                tree.insert(std::to_string(i), i);
+            }
+            tree.clear();
+        }
+        writer_done = true;
+    });
+
+    std::thread reader([&]() {
+        int key = 0;
+        while (!writer_done.load()) {
+            auto found = tree.find(std::to_string(key));
+            ASSERT_LE(found.size(), 1u);
+            if (!found.empty()) {
+                ASSERT_EQ(found[0], key);
+            }
+            tree.range_search("1", "2");
+            key = (key + 7) % 300;
+        }
+    });
+
+    writer.join();
+    reader.join();
+    EXPECT_TRUE(tree.empty());
+}
+
+
+TEST(BPlusTreeBLinkTest, RandomInsertRemoveMatchesMultimap) {
+    BPlusTree<int, int, 4> tree(ConcurrencyMode::BLink);
+    std::multimap<int, int> reference;
+    std::mt19937 rng(7);
+
+    for (int i = 0; i < 5000; ++i) {
+        int key = static_cast<int>(rng() % 500);
+        if (rng() % 3 == 0) {
+            tree.remove(key);
+            auto it = reference.find(key);
+            if (it != reference.end()) {
+                reference.erase(it);
+            }
+        } else {
+            tree.insert(key, i);
+            reference.emplace(key, i);
+        }
+    }
+
+    for (int key = 0; key < 500; ++key) {
+        ASSERT_EQ(tree.find(key).size(), reference.count(key)) << "key " << key;
+    }
+    EXPECT_EQ(tree.range_search(100, 300).size(),
+              static_cast<size_t>(std::distance(reference.lower_bound(100), reference.upper_bound(300))));
+
+    BPlusTree<int, int, 4> copy(tree);
+    EXPECT_EQ(copy.mode(), ConcurrencyMode::BLink);
+
+    std::vector<int> keys;
+    for (const auto& pair : copy) {
+        keys.push_back(pair.first_);
+    }
+    ASSERT_EQ(keys.size(), reference.size());
+    EXPECT_TRUE(std::is_sorted(keys.begin(), keys.end()));
+}
+
+TEST(BPlusTreeBLinkTest, EmptiedLeavesStayInPlace) {
+    BPlusTree<int, int, 4> tree(ConcurrencyMode::BLink);
+    for (int i = 0; i < 1000; ++i) {
+        tree.insert(i, i);
+    }
+    size_t height = tree.height();
+
+    // Nodes are never merged, so the tree keeps its shape with empty leaves
+    for (int i = 0; i < 1000; i += 2) {
+        tree.remove(i);
+    }
+    EXPECT_EQ(tree.height(), height);
+    EXPECT_EQ(tree.range_search(0, 999).size(), 500);
+
+    for (int i = 1; i < 1000; i += 2) {
+        tree.remove(i);
+    }
+    EXPECT_TRUE(tree.empty());
+    EXPECT_TRUE(tree.begin() == tree.end());
+    EXPECT_TRUE(tree.find(1).empty());
+
+    tree.insert(500, 1);
+    EXPECT_EQ(tree.find(500).size(), 1);
+    EXPECT_EQ((*tree.begin()).first_, 500);
+}
+
+TEST(BPlusTreeBLinkTest, ConcurrentWritersAndReaders) {
+    BPlusTree<std::string, int, 8> tree(ConcurrencyMode::BLink);
+    const int WRITERS = 4;
+    const int KEYS_PER_WRITER = 2000;
+    auto key_of = [](int i) {
+        std::string digits = std::to_string(i);
+        return std::string(6 - digits.size(), '0') + digits;
+    };
+
+    // Readers look for keys that are present for the whole test
+    for (int i = 0; i < WRITERS * KEYS_PER_WRITER; i += 100) {
+        tree.insert(key_of(i) + "!", i);
+    }
+
+    std::atomic<bool> writers_done{false};
+    std::vector<std::thread> threads;
+
+    for (int w = 0; w < WRITERS; ++w) {
+        threads.emplace_back([&tree, &key_of, w]() {
+            for (int i = 0; i < KEYS_PER_WRITER; ++i) {
+                int key = i * WRITERS + w;
+                tree.insert(key_of(key), key);
+            }
+            for (int i = 0; i < KEYS_PER_WRITER; ++i) {
+                int key = i * WRITERS + w;
+                if (key % 2 == 1) {
+                    tree.remove(key_of(key));
+                }
+            }
+        });
+    }
+
+    for (int r = 0; r < 2; ++r) {
+        threads.emplace_back([&tree, &writers_done, &key_of, r]() {
+            int stable = r * 100;
+            while (!writers_done.load()) {
+                ASSERT_EQ(tree.find(key_of(stable) + "!").size(), 1u) << "key " << stable;
+                stable = (stable + 200) % (WRITERS * KEYS_PER_WRITER);
+
+                auto range = tree.range_search(key_of(1000), key_of(2000));
+                for (size_t i = 1; i < range.size(); ++i) {
+                    ASSERT_LE(range[i - 1], range[i]);
+                }
+            }
+        });
+    }
+
+    for (int w = 0; w < WRITERS; ++w) {
+        threads[w].join();
+    }
+    writers_done = true;
+    for (size_t t = WRITERS; t < threads.size(); ++t) {
+        threads[t].join();
+    }
+
+    for (int key = 0; key < WRITERS * KEYS_PER_WRITER; ++key) {
+        ASSERT_EQ(tree.find(key_of(key)).size(), key % 2 == 0 ? 1u : 0u) << "key " << key;
+    }
+}
+
+TEST(BPlusTreeBLinkTest, OptimisticReadersMoveRight) {
+    BPlusTree<int, int, 8> tree(ConcurrencyMode::BLink);
+    std::atomic<bool> writer_done{false};
+
+    for (int i = 0; i < 1000; i += 10) {
+        tree.insert(i, i);
+    }
+
+    // Sequential ingest keeps splitting the rightmost nodes the readers land on
+    std::thread writer([&tree, &writer_done]() {
+        for (int i = 1; i < 20000; ++i) {
+            if (i % 10 != 0) {
+                tree.insert(i % 1000, -1);
+            }
+        }
+        writer_done = true;
+    });
+
+    std::thread reader([&tree, &writer_done]() {
+        int key = 0;
+        while (!writer_done.load()) {
+            auto found = tree.find(key);
+            ASSERT_FALSE(found.empty()) << "key " << key;
+            key = (key + 10) % 1000;
+        }
+    });
+
+    writer.join();
+    reader.join();
+    EXPECT_EQ(tree.range_search(0, 999).size(), 100 + 18000);
+}
@@ -1,5 +1,7 @@
 #include "../src/BP-Tree.hpp"
 #include "gtest/gtest.h"
+#include <limits>
+#include <vector>
 
 
 class CompositeKeyTest : public ::testing::Test {
@@ -322,3 +324,32 @@ TEST_F(CompositeKeyTest, FilterIteratorComplex) {
     EXPECT_TRUE(std::find(second_components.begin(), 
                          second_components.end(), "c") != second_components.end());
 }
+
+
+TEST_F(CompositeKeyTest, PrefixSearchOnLeadingComponents) {
+    using KeyType = CompositeKey<int, std::string, double>;
+    BPlusTree<KeyType, int, 4> tree;
+
+    int id = 0;
+    for (int tenant : {-2, 1, 2}) {
+        for (const char* name : {"", "a", "ab", "b"}) {
+            for (double version : {-std::numeric_limits<double>::infinity(), -1.0, 3.0}) {
+                tree.insert(KeyType(tenant, name, version), id++);
+            }
+        }
+    }
+
+    EXPECT_EQ(tree.prefix_search(CompositeKey<int>(1)).size(), 12u);
+    EXPECT_EQ(tree.prefix_search(CompositeKey<int>(-2)).size(), 12u);
+    EXPECT_TRUE(tree.prefix_search(CompositeKey<int>(0)).empty());
+
+    // The smallest name and version under the prefix are found too
+    auto named = tree.prefix_search(CompositeKey<int, std::string>(2, ""));
+    EXPECT_EQ(std::vector<int>(named.begin(), named.end()), (std::vector<int>{24, 25, 26}));
+    EXPECT_EQ(tree.prefix_search(CompositeKey<int, std::string>(1, "a")).size(), 3u);
+    EXPECT_EQ(tree.prefix_search(CompositeKey<int, std::string, double>(1, "ab", -1.0)).size(), 1u);
+
+    static_assert(is_leading_prefix<KeyType, CompositeKey<int, std::string>>::value);
+    static_assert(!is_leading_prefix<KeyType, CompositeKey<std::string>>::value);
+    static_assert(!is_leading_prefix<KeyType, CompositeKey<int, std::string, double, int>>::value);
+}
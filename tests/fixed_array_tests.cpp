@@ -0,0 +1,63 @@
+#include "../src/Fixed-Array.hpp"
+#include "gtest/gtest.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+
+TEST(FixedArrayTest, InsertAndEraseKeepOrder) {
+    FixedArray<int, 8> array;
+    array.push_back(1);
+    array.push_back(4);
+    array.insert(array.begin() + 1, 2);
+
+    std::vector<int> tail = {5, 6};
+    array.insert(array.end(), tail.begin(), tail.end());
+    array.insert(array.begin() + 2, 3);
+
+    ASSERT_EQ(array.size(), 6u);
+    for (size_t i = 0; i < array.size(); ++i) {
+        EXPECT_EQ(array[i], static_cast<int>(i + 1));
+    }
+
+    array.erase(array.begin());
+    array.pop_back();
+    EXPECT_EQ(array.front(), 2);
+    EXPECT_EQ(array.back(), 5);
+    EXPECT_EQ(array.size(), 4u);
+    EXPECT_EQ((FixedArray<int, 8>::capacity()), 8u);
+}
+
+
+TEST(FixedArrayTest, AssignAndResize) {
+    FixedArray<std::string, 4> array;
+    std::vector<std::string> source = {"a", "b", "c"};
+    array.assign(source.begin(), source.end());
+    EXPECT_EQ(array.size(), 3u);
+    EXPECT_EQ(array[2], "c");
+
+    array.resize(1);
+    EXPECT_EQ(array.size(), 1u);
+    array.resize(2);
+    EXPECT_EQ(array[1], "");
+
+    array.clear();
+    EXPECT_TRUE(array.empty());
+}
+
+
+TEST(FixedArrayTest, RemovedElementsAreReleased) {
+    auto owned = std::make_shared<int>(7);
+    FixedArray<std::shared_ptr<int>, 4> array;
+    array.push_back(owned);
+    array.push_back(owned);
+    array.push_back(owned);
+    EXPECT_EQ(owned.use_count(), 4);
+
+    array.erase(array.begin());
+    EXPECT_EQ(owned.use_count(), 3);
+    array.pop_back();
+    EXPECT_EQ(owned.use_count(), 2);
+    array.resize(0);
+    EXPECT_EQ(owned.use_count(), 1);
+}
@@ -1,6 +1,7 @@
 #include <cmath>
 #include <gtest/gtest.h>
 #include "../src/Index.hpp"
+#include <memory_resource>
 #include <string>
 
 using TestRecord = Record<std::string, int, double>; // Name, age, height
@@ -214,6 +215,20 @@ TEST_F(IndexTest, MultiplePredicates) {
     EXPECT_EQ(tall[0].get<0>(), "Vladimir");
 }
 
+TEST_F(IndexTest, ScanStreamsRecords) {
+    std::vector<std::string> names;
+    size_t visited = age_index.scan(26, 40, [&names](const TestRecord& r) {
+        names.push_back(r.get<0>());
+    });
+    EXPECT_EQ(visited, 2);
+    ASSERT_EQ(names.size(), 2);
+    EXPECT_EQ(names[0], "Vladimir");
+    EXPECT_EQ(names[1], "Charlie");
+
+    visited = age_index.scan(0, 100, [](const TestRecord&) { return false; });
+    EXPECT_EQ(visited, 1);
+}
+
 TEST_F(IndexTest, ResultOrder) {
     auto results = age_index.range_search(25, 35);
     EXPECT_EQ(results.size(), 3);
@@ -223,6 +238,57 @@ TEST_F(IndexTest, ResultOrder) {
 }
 
 
+TEST(IndexBulkLoadTest, PopulatesIndexes) {
+    std::vector<TestRecord> records;
+    for (size_t id = 0; id < 500; ++id) {
+        records.emplace_back(id, "name" + std::to_string(id % 50), static_cast<int>(id % 40), 1.5);
+    }
+
+    Index<TestRecord, int> age_index([](const TestRecord& r) { return r.get<1>(); });
+    // A rejected load leaves the index empty, so it can be loaded again
+    EXPECT_THROW(age_index.bulk_load(records.begin(), records.end(), 1.5), std::invalid_argument);
+    EXPECT_EQ(age_index.size(), 0);
+    age_index.bulk_load(records.begin(), records.end(), 0.8);
+    EXPECT_EQ(age_index.size(), 500);
+    auto results = age_index.find(7);
+    ASSERT_EQ(results.size(), 13);
+    for (const auto& record : results) {
+        EXPECT_EQ(record.get<1>(), 7);
+    }
+    EXPECT_EQ(age_index.range_search(0, 9).size(), 130);
+    EXPECT_THROW(age_index.bulk_load(records.begin(), records.end()), std::logic_error);
+
+    CompositeIndex<TestRecord, std::string, int> name_age_index(
+        [](const TestRecord& r) { return r.get<0>(); },
+        [](const TestRecord& r) { return r.get<1>(); }
+    );
+    EXPECT_THROW(name_age_index.bulk_load(records.begin(), records.end(), 0.0), std::invalid_argument);
+    name_age_index.bulk_load(records.begin(), records.end());
+    EXPECT_EQ(name_age_index.find(CompositeKey<std::string, int>("name7", 7)).size(), 3);
+}
+
+TEST(IndexMemoryResourceTest, RecordsAndNodesLiveInArena) {
+    // No upstream: anything the arena cannot serve from its buffer throws
+    std::vector<std::byte> buffer(1 << 22);
+    std::pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size(), std::pmr::null_memory_resource());
+
+    Index<TestRecord, int> age_index([](const TestRecord& r) { return r.get<1>(); }, &arena);
+    for (size_t id = 0; id < 2000; ++id) {
+        age_index.insert(TestRecord(id, "name", static_cast<int>(id % 100), 1.5));
+    }
+    EXPECT_EQ(age_index.size(), 2000);
+    EXPECT_EQ(age_index.find(42).size(), 20);
+    EXPECT_EQ(age_index.range_search(10, 19).size(), 200);
+
+    CompositeIndex<TestRecord, std::string, int> name_age_index(
+        &arena,
+        [](const TestRecord& r) { return r.get<0>(); },
+        [](const TestRecord& r) { return r.get<1>(); }
+    );
+    name_age_index.insert(TestRecord(0, "Victor", 25, 1.75));
+    EXPECT_EQ(name_age_index.find(CompositeKey<std::string, int>("Victor", 25)).size(), 1);
+}
+
 
 class PerformanceTest : public ::testing::Test {
   protected:
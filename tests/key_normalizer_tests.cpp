@@ -0,0 +1,137 @@
+#include "../src/Normalized-Key-Tree.hpp"
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+
+namespace {
+
+using Key = CompositeKey<int32_t, std::string, double>;
+
+Key random_key(std::mt19937& rng) {
+    static const std::string strings[] = {"", std::string("\0", 1), std::string("a\0b", 3), "a", "ab", "b"};
+    static const double doubles[] = {-1e300, -1.5, -0.0, 0.0, 1e-300, 2.5, std::numeric_limits<double>::infinity()};
+    int32_t number = static_cast<int32_t>(rng() % 5) - 2;
+    if (rng() % 8 == 0) {
+        number = rng() % 2 ? std::numeric_limits<int32_t>::min() : std::numeric_limits<int32_t>::max();
+    }
+    return Key(number, strings[rng() % 6], doubles[rng() % 7]);
+}
+
+} // namespace
+
+
+TEST(KeyNormalizerTest, BytesSortLikeTheKeys) {
+    std::mt19937 rng(23);
+    std::vector<Key> keys(300);
+    for (auto& key : keys) {
+        key = random_key(rng);
+    }
+
+    for (const auto& a : keys) {
+        std::string encoded = normalize_key(a);
+        EXPECT_TRUE(denormalize_key<Key>(encoded) == a);
+        for (const auto& b : keys) {
+            EXPECT_EQ(a < b, encoded < normalize_key(b));
+        }
+    }
+}
+
+
+TEST(KeyNormalizerTest, ScalarEncodings) {
+    EXPECT_LT(normalize_key(int64_t(-1)), normalize_key(int64_t(0)));
+    EXPECT_LT(normalize_key(std::numeric_limits<int64_t>::min()), normalize_key(int64_t(-1)));
+    EXPECT_LT(normalize_key(uint16_t(255)), normalize_key(uint16_t(256)));
+    EXPECT_EQ(normalize_key(uint32_t(0x01020304)), std::string("\x01\x02\x03\x04", 4));
+    EXPECT_LT(normalize_key(false), normalize_key(true));
+
+    EXPECT_EQ(normalize_key(-0.0), normalize_key(0.0));
+    EXPECT_LT(normalize_key(-std::numeric_limits<float>::infinity()), normalize_key(-1.0f));
+    EXPECT_LT(normalize_key(-1.0f), normalize_key(std::numeric_limits<float>::denorm_min()));
+    EXPECT_EQ(denormalize_key<float>(normalize_key(-3.25f)), -3.25f);
+
+    // The terminator sorts a string before its extensions, including ones with a zero byte
+    EXPECT_EQ(normalize_key(std::string("a")), std::string("a\0\0", 3));
+    EXPECT_LT(normalize_key(std::string("a")), normalize_key(std::string("a\0", 2)));
+    EXPECT_EQ(denormalize_key<std::string>(normalize_key(std::string("\0x\0", 3))), std::string("\0x\0", 3));
+}
+
+
+template <typename Tree>
+void check_normalized_tree() {
+    Tree tree;
+    std::multimap<Key, int> reference;
+    std::mt19937 rng(123);
+
+    for (int i = 0; i < 5000; ++i) {
+        Key key = random_key(rng);
+        if (rng() % 4 == 0) {
+            tree.remove(key);
+            auto it = reference.find(key);
+            if (it != reference.end()) {
+                reference.erase(it);
+            }
+        } else {
+            tree.insert(key, i);
+            reference.emplace(key, i);
+        }
+    }
+
+    for (int i = 0; i < 200; ++i) {
+        Key key = random_key(rng);
+        EXPECT_EQ(tree.find(key).size(), reference.count(key));
+    }
+
+    Key from(-1, "a", -1.5);
+    Key to(1, "", 0.0);
+    auto expected = reference.lower_bound(from);
+    auto end = reference.upper_bound(to);
+    EXPECT_EQ(tree.range_search(from, to).size(), static_cast<size_t>(std::distance(expected, end)));
+
+    size_t visited = tree.scan(from, to, [&](const Key& key, int) {
+        EXPECT_TRUE(key == expected->first);
+        ++expected;
+    });
+    EXPECT_EQ(expected, end);
+    EXPECT_GT(visited, 0u);
+
+    for (int32_t number : {-2, 0, std::numeric_limits<int32_t>::max()}) {
+        size_t matches = std::count_if(reference.begin(), reference.end(), [number](const auto& entry) {
+            return entry.first.template get<0>() == number;
+        });
+        EXPECT_EQ(tree.prefix_search(CompositeKey<int32_t>(number)).size(), matches);
+    }
+    auto with_name = reference.lower_bound(Key(1, "a", -std::numeric_limits<double>::infinity()));
+    auto past_name = reference.lower_bound(Key(1, std::string("a\0", 2), -std::numeric_limits<double>::infinity()));
+    EXPECT_EQ(tree.prefix_search(CompositeKey<int32_t, std::string>(1, "a")).size(),
+              static_cast<size_t>(std::distance(with_name, past_name)));
+}
+
+TEST(NormalizedKeyTreeTest, InlineKeysMatchMultimap) {
+    check_normalized_tree<NormalizedKeyTree<Key, int, 8>>();
+}
+
+TEST(NormalizedKeyTreeTest, StringKeysMatchMultimap) {
+    check_normalized_tree<NormalizedKeyTree<Key, int, 8, 0>>();
+}
+
+TEST(NormalizedKeyTreeTest, InlineKeysOrderLikeByteStrings) {
+    using Short = NormalizedKey<8>;
+    EXPECT_LT(Short(std::string("a")), Short(std::string("a\0", 2)));
+    EXPECT_LT(Short(std::string("a\xFF")), Short(std::string("b")));
+    EXPECT_FALSE(Short(std::string("ab")) < Short(std::string("ab")));
+    EXPECT_EQ(Short(std::string("ab")).view(), "ab");
+    EXPECT_THROW(Short(std::string(9, 'x')), std::length_error);
+    static_assert(std::is_trivially_copyable_v<Short>);
+
+    NormalizedKeyTree<Key, int, 8, 16> tree;
+    EXPECT_THROW(tree.insert(Key(1, std::string(16, 'x'), 0.0), 1), std::length_error);
+    EXPECT_TRUE(tree.find(Key(1, "x", 0.0)).empty());
+}
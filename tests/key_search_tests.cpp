@@ -0,0 +1,55 @@
+#include "../src/Key-Search.hpp"
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+
+template <typename Key>
+class KeySearchTest : public ::testing::Test {};
+
+using SearchableKeys = ::testing::Types<int32_t, uint32_t, int64_t, uint64_t, float, double>;
+TYPED_TEST_SUITE(KeySearchTest, SearchableKeys);
+
+
+TYPED_TEST(KeySearchTest, MatchesStdLowerBound) {
+    using Key = TypeParam;
+    static_assert(simd_searchable<Key, std::less<Key>>);
+
+    std::mt19937_64 rng(3);
+    for (size_t size : {0, 1, 3, 7, 8, 17, 64, 127, 128, 300}) {
+        // Duplicates and values from both ends of the range, so unsigned keys with the
+        // top bit set are covered
+        std::vector<Key> keys(size);
+        for (auto& key : keys) {
+            key = rng() % 4 == 0 ? std::numeric_limits<Key>::max()
+                                 : static_cast<Key>(rng() % 50);
+        }
+        std::sort(keys.begin(), keys.end());
+
+        std::vector<Key> probes = {std::numeric_limits<Key>::lowest(), std::numeric_limits<Key>::max()};
+        for (int i = -1; i <= 51; ++i) {
+            probes.push_back(static_cast<Key>(i));
+        }
+
+        const Key* first = keys.data();
+        const Key* last = keys.data() + keys.size();
+        for (Key probe : probes) {
+            EXPECT_EQ(key_lower_bound(first, last, probe, std::less<Key>()),
+                      std::lower_bound(first, last, probe)) << "size " << size;
+        }
+    }
+}
+
+
+TEST(KeySearchFallbackTest, OtherKeysUseComparator) {
+    static_assert(!simd_searchable<std::string, std::less<std::string>>);
+    static_assert(!simd_searchable<int, std::greater<int>>);
+
+    std::vector<int> descending = {9, 7, 7, 4, 1};
+    auto it = key_lower_bound(descending.data(), descending.data() + descending.size(), 7, std::greater<int>());
+    EXPECT_EQ(it - descending.data(), 1);
+}
@@ -0,0 +1,296 @@
+#include "../src/BP-Tree.hpp"
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <map>
+#include <memory_resource>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+namespace {
+
+template <size_t Capacity>
+void expect_prefixes_match(const PrefixedKeys<std::string, Capacity>& keys) {
+    for (size_t i = 0; i < Capacity; ++i) {
+        uint64_t expected = i < keys.size() ? KeyStem<std::string>::prefix(keys[i], keys.stem()) : 0;
+        EXPECT_EQ(keys.prefixes()[i], expected) << "slot " << i;
+        if (i < keys.size()) {
+            EXPECT_GE(KeyStem<std::string>::shared(keys[i], keys.front()), keys.stem()) << "slot " << i;
+        }
+    }
+}
+
+std::string random_key(std::mt19937& rng) {
+    // Most keys share far more than a prefix's worth of leading bytes
+    static const std::string stems[] = {"https://example.com/", "https://example.org/", "a", ""};
+    std::string key = stems[rng() % 4];
+    size_t length = rng() % 4;
+    for (size_t i = 0; i < length; ++i) {
+        key += static_cast<char>('a' + rng() % 3);
+    }
+    return key;
+}
+
+template <typename Tree>
+void expect_string_tree_matches_multimap(Tree& tree) {
+    std::multimap<std::string, int> reference;
+    std::mt19937 rng(122);
+
+    for (int i = 0; i < 20000; ++i) {
+        std::string key = random_key(rng);
+        if (rng() % 3 == 0) {
+            tree.remove(key);
+            auto it = reference.find(key);
+            if (it != reference.end()) {
+                reference.erase(it);
+            }
+        } else {
+            tree.insert(key, i);
+            reference.emplace(key, i);
+        }
+    }
+
+    EXPECT_GT(tree.height(), 2);
+    size_t visited = 0;
+    for (const auto& pair : tree) {
+        (void)pair;
+        ++visited;
+    }
+    EXPECT_EQ(visited, reference.size());
+
+    for (auto it = reference.begin(); it != reference.end(); it = reference.upper_bound(it->first)) {
+        EXPECT_EQ(tree.find(it->first).size(), reference.count(it->first)) << it->first;
+        EXPECT_EQ((*tree.lower_bound(it->first)).first_, it->first);
+    }
+    EXPECT_TRUE(tree.find("https://example.com/zzz").empty());
+
+    auto range = tree.range_search("https://example.com/a", "https://example.com/b");
+    auto first = reference.lower_bound("https://example.com/a");
+    auto last = reference.upper_bound("https://example.com/b");
+    EXPECT_EQ(range.size(), static_cast<size_t>(std::distance(first, last)));
+}
+
+} // namespace
+
+
+TEST(PrefixedKeysTest, PrefixesFollowTheKeys) {
+    PrefixedKeys<std::string, 8> keys;
+    keys.push_back("delta");
+    keys.insert(keys.begin(), "alpha");
+    keys.insert(keys.begin() + 1, std::string("charlie"));
+
+    std::vector<std::string> tail = {"echo", "foxtrot-and-more"};
+    keys.insert(keys.end(), tail.begin(), tail.end());
+    keys.insert(keys.begin() + 1, "bravo");
+    ASSERT_EQ(keys.size(), 6u);
+    EXPECT_TRUE(std::is_sorted(keys.begin(), keys.end()));
+    expect_prefixes_match(keys);
+
+    keys.erase(keys.begin() + 2);
+    keys.pop_back();
+    EXPECT_EQ(keys.front(), "alpha");
+    EXPECT_EQ(keys.back(), "echo");
+    expect_prefixes_match(keys);
+
+    keys.assign(tail.begin(), tail.end());
+    expect_prefixes_match(keys);
+    keys.resize(5);
+    expect_prefixes_match(keys);
+    keys.clear();
+    expect_prefixes_match(keys);
+
+    // Bytes beyond the prefix and embedded zeros are left to the full comparison
+    EXPECT_EQ(KeyPrefix<std::string>::of("abcdefgh"), KeyPrefix<std::string>::of("abcdefghij"));
+    EXPECT_EQ(KeyPrefix<std::string>::of("ab"), KeyPrefix<std::string>::of(std::string("ab\0", 3)));
+    EXPECT_LT(KeyPrefix<std::string>::of("ab"), KeyPrefix<std::string>::of("ab\x80"));
+    EXPECT_EQ((KeyPrefix<CompositeKey<std::string, int>>::of({"abc", 1})), KeyPrefix<std::string>::of("abc"));
+    static_assert(!KeyPrefix<int>::enabled);
+}
+
+
+TEST(PrefixedKeysTest, PrefixesStartAfterTheSharedStem) {
+    PrefixedKeys<std::string, 8> keys;
+    keys.push_back("https://example.com/b");
+    EXPECT_EQ(keys.stem(), 21u);
+    keys.push_back("https://example.com/d");
+    keys.insert(keys.begin(), "https://example.com/a");
+    EXPECT_EQ(keys.stem(), 20u);
+    expect_prefixes_match(keys);
+    EXPECT_NE(keys.prefixes()[0], keys.prefixes()[1]);
+
+    keys.insert(keys.begin() + 3, "https://example.org/");
+    EXPECT_EQ(keys.stem(), 16u);
+    expect_prefixes_match(keys);
+
+    // Erasing leaves the stem short; replacing the keys recomputes it
+    keys.erase(keys.begin() + 3);
+    EXPECT_EQ(keys.stem(), 16u);
+    expect_prefixes_match(keys);
+    std::vector<std::string> paths = {"/usr/lib/a", "/usr/lib/b"};
+    keys.assign(paths.begin(), paths.end());
+    EXPECT_EQ(keys.stem(), 9u);
+    expect_prefixes_match(keys);
+
+    // Keys that leave the stem go before or after all of them
+    std::less<std::string> less;
+    EXPECT_EQ(keys.lower_bound(0, 2, "/usr/", less), 0u);
+    EXPECT_EQ(keys.lower_bound(0, 2, "/usr/libx", less), 2u);
+    EXPECT_EQ(keys.lower_bound(0, 2, "/usr/lib/b", less), 1u);
+    EXPECT_EQ(keys.lower_bound(1, 1, "/usr/lib/a", less), 1u);
+}
+
+
+TEST(PrefixedKeysTest, SeparatorIsShortestKeyBetweenNeighbours) {
+    using Stem = KeyStem<std::string>;
+    EXPECT_EQ(Stem::separator("/usr/lib/alpha", "/usr/lib/beta"), "/usr/lib/b");
+    EXPECT_EQ(Stem::separator("/usr/lib", "/usr/lib/beta"), "/usr/lib/");
+    EXPECT_EQ(Stem::separator("/usr/lib/a", "/usr/lib/b"), "/usr/lib/b");
+    EXPECT_EQ(Stem::separator("", "b"), "b");
+    EXPECT_EQ(Stem::shared("abc", "abd"), 2u);
+    EXPECT_EQ(Stem::prefix("abcdefghij", 8), KeyPrefix<std::string>::of("ij"));
+}
+
+
+TEST(PrefixedKeysTest, LowerBoundMatchesFullKeySearch) {
+    std::mt19937 rng(22);
+
+    for (int round = 0; round < 200; ++round) {
+        std::vector<std::string> sorted(rng() % 64);
+        for (auto& key : sorted) {
+            key = random_key(rng);
+        }
+        std::sort(sorted.begin(), sorted.end());
+
+        PrefixedKeys<std::string, 64> keys;
+        keys.assign(sorted.begin(), sorted.end());
+
+        for (int probe = 0; probe < 50; ++probe) {
+            std::string key = random_key(rng);
+            size_t from = sorted.empty() ? 0 : rng() % (sorted.size() + 1);
+            size_t expected = std::lower_bound(sorted.begin() + from, sorted.end(), key) - sorted.begin();
+            EXPECT_EQ(keys.lower_bound(from, sorted.size(), key, std::less<std::string>()), expected);
+        }
+    }
+}
+
+
+TEST(PrefixedKeysTest, StringTreeMatchesMultimap) {
+    BPlusTree<std::string, int, 8> tree;
+    expect_string_tree_matches_multimap(tree);
+}
+
+TEST(PrefixedKeysTest, SlabStringTreeMatchesMultimap) {
+    BPlusTree<std::string, int, 64, std::less<std::string>, 64, SlabNodeAllocator> tree;
+    expect_string_tree_matches_multimap(tree);
+}
+
+// The prefix array is read with the leaf's own alignment, so every allocator has to
+// place leaves at it
+TEST(PrefixedKeysTest, LeavesAreAlignedWhereTheyAreAllocated) {
+    using Leaf = LeafNode<std::string, int, 64>;
+    static_assert(alignof(Leaf) <= alignof(std::max_align_t));
+
+    HeapNodeAllocator heap;
+    SlabNodeAllocator slab;
+    std::pmr::monotonic_buffer_resource arena;
+    HeapNodeAllocator in_arena(&arena);
+    std::vector<NodePtr<Leaf>> leaves;
+    for (int i = 0; i < 8; ++i) {
+        leaves.push_back(heap.make<Leaf>());
+        leaves.push_back(slab.make<Leaf>());
+        leaves.push_back(in_arena.make<Leaf>());
+    }
+    for (const auto& leaf : leaves) {
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(leaf.get()) % alignof(Leaf), 0u);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(leaf->keys_.prefixes()) % alignof(uint64_t), 0u);
+    }
+}
+
+
+// Order 64 leaves look around their middle for the shortest separator; every path
+// that creates separators must still route all keys to where they are
+TEST(PrefixedKeysTest, TruncatedSeparatorsRouteLikeFullKeys) {
+    std::mt19937 rng(24);
+    auto path = [&rng]() {
+        std::string key = "/srv/data/";
+        for (int level = 0; level < 3; ++level) {
+            key += "dir" + std::to_string(rng() % 12) + "/";
+        }
+        return key + "file" + std::to_string(rng() % 100);
+    };
+
+    for (ConcurrencyMode mode : {ConcurrencyMode::LatchCoupling, ConcurrencyMode::BLink}) {
+        BPlusTree<std::string, int, 64> tree(mode);
+        std::multimap<std::string, int> reference;
+
+        std::vector<std::pair<std::string, int>> loaded;
+        for (int i = 0; i < 3000; ++i) {
+            loaded.emplace_back(path(), i);
+        }
+        std::sort(loaded.begin(), loaded.end());
+        tree.bulk_load(loaded.begin(), loaded.end(), 0.7);
+        reference.insert(loaded.begin(), loaded.end());
+
+        std::vector<std::pair<std::string, int>> batch;
+        for (int i = 0; i < 3000; ++i) {
+            batch.emplace_back(path(), i);
+        }
+        std::sort(batch.begin(), batch.end());
+        tree.insert_batch(batch);
+        reference.insert(batch.begin(), batch.end());
+
+        for (int i = 0; i < 20000; ++i) {
+            std::string key = path();
+            if (rng() % 3 == 0) {
+                tree.remove(key);
+                auto it = reference.find(key);
+                if (it != reference.end()) {
+                    reference.erase(it);
+                }
+            } else {
+                tree.insert(key, i);
+                reference.emplace(key, i);
+            }
+        }
+
+        size_t visited = 0;
+        for (const auto& pair : tree) {
+            (void)pair;
+            ++visited;
+        }
+        EXPECT_EQ(visited, reference.size());
+        for (int i = 0; i < 2000; ++i) {
+            std::string key = path();
+            EXPECT_EQ(tree.find(key).size(), reference.count(key)) << key;
+        }
+    }
+}
+
+
+TEST(PrefixedKeysTest, PrefixSearchMatchesStartsWith) {
+    BPlusTree<std::string, int, 8> tree;
+    std::vector<std::string> keys;
+    std::mt19937 rng(25);
+    for (int i = 0; i < 3000; ++i) {
+        keys.push_back(random_key(rng));
+    }
+    for (std::string key : {"a\xFF", "a\xFF\xFF", "b\xFF", "\xFF", "\xFF\xFFz"}) {
+        keys.push_back(key);
+    }
+    for (size_t i = 0; i < keys.size(); ++i) {
+        tree.insert(keys[i], static_cast<int>(i));
+    }
+
+    for (std::string prefix : {"", "a", "https://example.com/", "https://example.com/ab", "a\xFF", "\xFF", "\xFF\xFF", "zz"}) {
+        size_t expected = std::count_if(keys.begin(), keys.end(), [&prefix](const std::string& key) {
+            return std::string_view(key).starts_with(prefix);
+        });
+        auto ids = tree.prefix_search(prefix);
+        EXPECT_EQ(ids.size(), expected) << prefix;
+        for (int id : ids) {
+            EXPECT_TRUE(std::string_view(keys[id]).starts_with(prefix)) << keys[id];
+        }
+    }
+}